@@ -10,6 +10,53 @@
 #include <cmath>
 #include <thread>
 #include <future>
+#include <fstream>
+#include <memory>
+#include <stdexcept>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <cstdlib>
+#include <cstdint>
+#include <random>
+#include <sstream>
+#include <iomanip>
+#include <array>
+#include <utility>
+#include <chrono>
+#include <limits>
+#include <cstring>
+#include <cerrno>
+#include <optional>
+#include <filesystem>
+
+#ifdef __SSSE3__
+#include <tmmintrin.h>
+#endif
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <sys/wait.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sched.h>
+#include <spawn.h>
+extern char** environ;
+#endif
 
 // Define M_PI for Windows if not available
 #ifndef M_PI
@@ -18,192 +65,5361 @@
 
 namespace py = pybind11;
 
-class GroverAccelerator {
+/**
+ * Portable bit operations (GCC/Clang builtins, MSVC intrinsics elsewhere)
+ */
+namespace bits {
+    inline int popcount64(uint64_t x) {
+#if defined(__GNUC__) || defined(__clang__)
+        return __builtin_popcountll(x);
+#else
+        // SWAR count: MSVC's __popcnt64 needs a POPCNT-capable CPU
+        x = x - ((x >> 1) & 0x5555555555555555ULL);
+        x = (x & 0x3333333333333333ULL) + ((x >> 2) & 0x3333333333333333ULL);
+        x = (x + (x >> 4)) & 0x0F0F0F0F0F0F0F0FULL;
+        return static_cast<int>((x * 0x0101010101010101ULL) >> 56);
+#endif
+    }
+    
+    /**
+     * Index of the lowest set bit; x must be non-zero
+     */
+    inline int ctz64(uint64_t x) {
+#if defined(__GNUC__) || defined(__clang__)
+        return __builtin_ctzll(x);
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_ARM64))
+        unsigned long index;
+        _BitScanForward64(&index, x);
+        return static_cast<int>(index);
+#else
+        int n = 0;
+        while (!(x & 1)) { x >>= 1; ++n; }
+        return n;
+#endif
+    }
+    
+    inline uint64_t bswap64(uint64_t x) {
+#if defined(__GNUC__) || defined(__clang__)
+        return __builtin_bswap64(x);
+#elif defined(_MSC_VER)
+        return _byteswap_uint64(x);
+#else
+        x = ((x >> 8) & 0x00FF00FF00FF00FFULL) | ((x & 0x00FF00FF00FF00FFULL) << 8);
+        x = ((x >> 16) & 0x0000FFFF0000FFFFULL) | ((x & 0x0000FFFF0000FFFFULL) << 16);
+        return (x >> 32) | (x << 32);
+#endif
+    }
+}
+
+/**
+ * Compile-time 256-entry lookup tables for the nucleotide alphabet, shared by
+ * every kernel that inspects bases (validation, GC content, packing, reverse
+ * complement, IUPAC matching) so their hot loops index instead of branching
+ * and agree on what each byte means.
+ *
+ *   code       - 2-bit code A=0 C=1 G=2 T/U=3 (either case), kNoCode otherwise
+ *   iupac      - 4-bit set of bases a symbol stands for (A=1 C=2 G=4 T=8), 0 if none
+ *   complement - Watson-Crick / IUPAC complement preserving case; other bytes map to themselves
+ *   kind       - kBase (ACGT), kSoftMasked (acgt), kAmbiguous (other IUPAC codes, either case), kInvalid
+ *   gc         - 1 for G and C (uppercase, as in calculate_gc_content)
+ */
+namespace alphabet {
+    enum Kind : uint8_t { kInvalid = 0, kBase = 1, kSoftMasked = 2, kAmbiguous = 3 };
+    constexpr uint8_t kNoCode = 4;
+    constexpr uint8_t kA = 1, kC = 2, kG = 4, kT = 8;
+    
+    struct Tables {
+        std::array<uint8_t, 256> code{};
+        std::array<uint8_t, 256> iupac{};
+        std::array<uint8_t, 256> complement{};
+        std::array<uint8_t, 256> kind{};
+        std::array<uint8_t, 256> gc{};
+    };
+    
+    constexpr Tables make_tables() {
+        Tables t;
+        for (int c = 0; c < 256; ++c) {
+            t.code[c] = kNoCode;
+            t.complement[c] = static_cast<uint8_t>(c);
+        }
+        struct Symbol { char upper; uint8_t mask; char complement; };
+        constexpr Symbol symbols[] = {
+            {'A', kA, 'T'}, {'C', kC, 'G'}, {'G', kG, 'C'}, {'T', kT, 'A'}, {'U', kT, 'A'},
+            {'R', kA | kG, 'Y'}, {'Y', kC | kT, 'R'}, {'S', kC | kG, 'S'}, {'W', kA | kT, 'W'},
+            {'K', kG | kT, 'M'}, {'M', kA | kC, 'K'}, {'B', kC | kG | kT, 'V'}, {'V', kA | kC | kG, 'B'},
+            {'D', kA | kG | kT, 'H'}, {'H', kA | kC | kT, 'D'}, {'N', kA | kC | kG | kT, 'N'},
+        };
+        for (const Symbol& s : symbols) {
+            const uint8_t upper = static_cast<uint8_t>(s.upper);
+            const uint8_t lower = static_cast<uint8_t>(s.upper - 'A' + 'a');
+            const bool single = s.mask == kA || s.mask == kC || s.mask == kG || s.mask == kT;
+            const uint8_t code = s.mask == kA ? 0 : s.mask == kC ? 1 : s.mask == kG ? 2 : 3;
+            for (uint8_t c : {upper, lower}) {
+                t.iupac[c] = s.mask;
+                t.complement[c] = static_cast<uint8_t>(c == upper ? s.complement : s.complement - 'A' + 'a');
+                if (single) t.code[c] = code;
+            }
+            const bool canonical = single && s.upper != 'U';
+            t.kind[upper] = canonical ? kBase : kAmbiguous;
+            t.kind[lower] = canonical ? kSoftMasked : kAmbiguous;
+        }
+        t.gc[static_cast<uint8_t>('G')] = t.gc[static_cast<uint8_t>('C')] = 1;
+        return t;
+    }
+    
+    inline constexpr Tables kTables = make_tables();
+    
+    constexpr uint8_t code(char c) { return kTables.code[static_cast<uint8_t>(c)]; }
+    constexpr uint8_t iupac(char c) { return kTables.iupac[static_cast<uint8_t>(c)]; }
+    constexpr char complement(char c) { return static_cast<char>(kTables.complement[static_cast<uint8_t>(c)]); }
+    constexpr uint8_t kind(char c) { return kTables.kind[static_cast<uint8_t>(c)]; }
+    constexpr uint8_t gc(char c) { return kTables.gc[static_cast<uint8_t>(c)]; }
+    
+    static_assert(code('G') == 2 && code('t') == 3 && code('N') == kNoCode, "2-bit codes");
+    static_assert(complement('A') == 'T' && complement('r') == 'y' && complement('-') == '-', "complements");
+    static_assert(iupac('N') == 15 && (iupac('R') & iupac('G')) && kind('a') == kSoftMasked, "IUPAC sets");
+}
+
+/**
+ * Strand and reading-frame kernels over ASCII sequences, built on the
+ * alphabet tables. Reverse complement uses SSSE3 shuffles (16 bases per step)
+ * when the build enables them, with the table as fallback for blocks holding
+ * symbols other than ACGTN.
+ */
+namespace seqops {
+    constexpr uint64_t kNoKmer = ~uint64_t(0);  // Window contains a non-ACGT symbol
+    
+    // NCBI standard genetic code indexed by 2-bit codon code (A0 C1 G2 T3, first base high)
+    constexpr char kCodonTable[65] = "KNKNTTTTRSRSIIMIQHQHPPPPRRRRLLLLEDEDAAAAGGGGVVVV*Y*YSSSS*CWCLFLF";
+    
+    inline void reverse_complement_scalar(const char* in, size_t n, char* out) {
+        for (size_t i = 0; i < n; ++i) out[n - 1 - i] = alphabet::complement(in[i]);
+    }
+    
+    inline void reverse_complement(const char* in, size_t n, char* out) {
+        size_t done = 0;
+#ifdef __SSSE3__
+        // Within ACGTN (either case) the low nibble identifies the base, and
+        // complementing is an XOR: A^T = 0x15, C^G = 0x04
+        const __m128i low_mask = _mm_set1_epi8(0x0F);
+        const __m128i case_bit = _mm_set1_epi8(0x20);
+        const __m128i expected = _mm_setr_epi8(0, 'a', 0, 'c', 't', 0, 0, 'g', 0, 0, 0, 0, 0, 0, 'n', 0);
+        const __m128i delta = _mm_setr_epi8(0, 0x15, 0, 0x04, 0x15, 0, 0, 0x04, 0, 0, 0, 0, 0, 0, 0, 0);
+        const __m128i reverse = _mm_setr_epi8(15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0);
+        for (; done + 16 <= n; done += 16) {
+            const __m128i bases = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + done));
+            const __m128i low = _mm_and_si128(bases, low_mask);
+            const __m128i known = _mm_cmpeq_epi8(_mm_or_si128(bases, case_bit), _mm_shuffle_epi8(expected, low));
+            char* dst = out + n - done - 16;
+            if (_mm_movemask_epi8(known) != 0xFFFF) {
+                reverse_complement_scalar(in + done, 16, dst);
+                continue;
+            }
+            const __m128i complemented = _mm_xor_si128(bases, _mm_shuffle_epi8(delta, low));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(dst), _mm_shuffle_epi8(complemented, reverse));
+        }
+#endif
+        for (size_t i = done; i < n; ++i) out[n - 1 - i] = alphabet::complement(in[i]);
+    }
+    
+    /**
+     * Translate from `offset` in codons; codons with a non-ACGT base give 'X'
+     */
+    inline std::string translate(const char* in, size_t n, size_t offset) {
+        std::string protein;
+        if (offset >= n) return protein;
+        protein.reserve((n - offset) / 3);
+        for (size_t i = offset; i + 3 <= n; i += 3) {
+            const uint8_t c0 = alphabet::code(in[i]), c1 = alphabet::code(in[i + 1]), c2 = alphabet::code(in[i + 2]);
+            protein += (c0 | c1 | c2) & alphabet::kNoCode ? 'X' : kCodonTable[c0 << 4 | c1 << 2 | c2];
+        }
+        return protein;
+    }
+    
+    /**
+     * Call fn(start, kmer) for every window of k ACGT symbols (k <= 32),
+     * rolling the forward and reverse-complement 2-bit codes; the kmer is the
+     * canonical (smaller) one when `canonical`, else the forward one
+     */
+    template <typename F>
+    inline void for_each_kmer(const char* in, size_t n, int k, bool canonical, F&& fn) {
+        const uint64_t mask = k == 32 ? ~uint64_t(0) : (uint64_t(1) << (2 * k)) - 1;
+        const int top = 2 * (k - 1);
+        uint64_t forward = 0, reverse = 0;
+        int valid = 0;  // Length of the current run of ACGT
+        for (size_t i = 0; i < n; ++i) {
+            const uint8_t c = alphabet::code(in[i]);
+            valid = c == alphabet::kNoCode ? 0 : valid + 1;
+            forward = ((forward << 2) | (c & 3)) & mask;
+            reverse = (reverse >> 2) | (uint64_t(3 - (c & 3)) << top);
+            if (valid >= k) fn(i + 1 - k, canonical ? std::min(forward, reverse) : forward);
+        }
+    }
+    
+    /**
+     * Canonical (lexicographically smaller of forward and reverse-complement)
+     * 2-bit k-mer at every window start, k <= 32; kNoKmer where the window
+     * holds a non-ACGT symbol
+     */
+    inline std::vector<uint64_t> canonical_kmers(const char* in, size_t n, int k) {
+        if (k < 1 || k > 32) throw std::invalid_argument("k must be between 1 and 32");
+        std::vector<uint64_t> kmers;
+        if (n < static_cast<size_t>(k)) return kmers;
+        kmers.assign(n - k + 1, kNoKmer);
+        for_each_kmer(in, n, k, true, [&](size_t start, uint64_t kmer) { kmers[start] = kmer; });
+        return kmers;
+    }
+    
+    /**
+     * 2-bit code of an ACGT string (first base in the high bits)
+     */
+    inline uint64_t encode_kmer(const std::string& kmer) {
+        uint64_t code = 0;
+        for (char base : kmer) {
+            const uint8_t c = alphabet::code(base);
+            if (c == alphabet::kNoCode) throw std::invalid_argument("k-mer must contain only A, C, G and T");
+            code = code << 2 | c;
+        }
+        return code;
+    }
+}
+
+/**
+ * 2-bit packed ACGT sequence, 32 bases per 64-bit word with base i in bits
+ * 2*(i % 32) of word i / 32. Reverse complement works a word at a time: a SWAR
+ * reversal of the 2-bit fields, an XOR with all ones (A<->T, C<->G), and a
+ * shift to realign the tail.
+ */
+class PackedSequence {
+public:
+    explicit PackedSequence(const std::string& sequence) : length_(sequence.size()), words_((sequence.size() + 31) / 32, 0) {
+        for (size_t i = 0; i < length_; ++i) {
+            const uint8_t c = alphabet::code(sequence[i]);
+            if (c == alphabet::kNoCode) {
+                throw std::invalid_argument("packed sequences hold only A, C, G and T");
+            }
+            words_[i / 32] |= uint64_t(c) << (2 * (i % 32));
+        }
+    }
+    
+    size_t length() const { return length_; }
+    const std::vector<uint64_t>& words() const { return words_; }
+    
+    uint8_t code(size_t i) const { return (words_[i / 32] >> (2 * (i % 32))) & 3; }
+    
+    std::string to_string() const {
+        static constexpr char kBases[] = "ACGT";
+        std::string sequence(length_, 'A');
+        for (size_t i = 0; i < length_; ++i) sequence[i] = kBases[code(i)];
+        return sequence;
+    }
+    
+    PackedSequence reverse_complement() const {
+        PackedSequence rc;
+        rc.length_ = length_;
+        const size_t W = words_.size();
+        rc.words_.resize(W);
+        for (size_t w = 0; w < W; ++w) rc.words_[W - 1 - w] = ~reverse_fields(words_[w]);
+        // Reversing W whole words puts base i at 32W - 1 - i; shift down to n - 1 - i
+        const unsigned shift = static_cast<unsigned>(2 * (32 * W - length_));
+        if (shift) {
+            for (size_t w = 0; w < W; ++w) {
+                const uint64_t next = w + 1 < W ? rc.words_[w + 1] : 0;
+                rc.words_[w] = (rc.words_[w] >> shift) | (next << (64 - shift));
+            }
+        }
+        return rc;
+    }
+    
+    std::vector<uint64_t> canonical_kmers(int k) const {
+        if (k < 1 || k > 32) throw std::invalid_argument("k must be between 1 and 32");
+        std::vector<uint64_t> kmers;
+        if (length_ < static_cast<size_t>(k)) return kmers;
+        kmers.resize(length_ - k + 1);
+        const uint64_t mask = k == 32 ? ~uint64_t(0) : (uint64_t(1) << (2 * k)) - 1;
+        const int top = 2 * (k - 1);
+        uint64_t forward = 0, reverse = 0;
+        for (size_t i = 0; i < length_; ++i) {
+            const uint64_t c = code(i);
+            forward = ((forward << 2) | c) & mask;
+            reverse = (reverse >> 2) | ((3 - c) << top);
+            if (i + 1 >= static_cast<size_t>(k)) kmers[i + 1 - k] = std::min(forward, reverse);
+        }
+        return kmers;
+    }
+    
+private:
+    PackedSequence() = default;
+    
+    static uint64_t reverse_fields(uint64_t x) {
+        x = ((x >> 2) & 0x3333333333333333ULL) | ((x & 0x3333333333333333ULL) << 2);
+        x = ((x >> 4) & 0x0F0F0F0F0F0F0F0FULL) | ((x & 0x0F0F0F0F0F0F0F0FULL) << 4);
+        return bits::bswap64(x);
+    }
+    
+    size_t length_ = 0;
+    std::vector<uint64_t> words_;
+};
+
+/**
+ * k-mer spectrum of a sequence: sorted distinct k-mers (2-bit codes, first
+ * base high) with their counts.
+ *
+ * Counting is two lock-free phases. Each thread rolls the k-mers of its slice
+ * of the sequence into its own open-addressing tables, one per radix
+ * partition (the top bits of the k-mer). Then each partition is claimed by
+ * one thread, which merges every thread's table for it and sorts the result;
+ * partitions are disjoint value ranges, so concatenating them in order gives
+ * the sorted spectrum. When per-thread dense 4^k arrays are small, they
+ * replace the tables and are summed by index range instead.
+ */
+class KmerSpectrum {
+public:
+    static constexpr int kMaxK = 31;                       // Leaves ~0 free as the empty-slot key
+    static constexpr int kMaxDenseK = 12;                  // dense() is at most 4^12 entries
+    static constexpr size_t kDenseCountingBytes = 256u << 20;  // Budget for per-thread dense arrays
+    
+    static KmerSpectrum count(const char* sequence, size_t n, int k, bool canonical, int num_threads) {
+        if (k < 1 || k > kMaxK) throw std::invalid_argument("k must be between 1 and 31");
+        if (num_threads <= 0) num_threads = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+        
+        KmerSpectrum spectrum;
+        spectrum.k_ = k;
+        spectrum.canonical_ = canonical;
+        if (n < static_cast<size_t>(k)) return spectrum;
+        
+        const size_t windows = n - k + 1;
+        num_threads = static_cast<int>(std::min<size_t>(num_threads, std::max<size_t>(1, windows / 4096)));
+        auto slice = [&](int t) {
+            const size_t begin = windows * t / num_threads;
+            const size_t end = windows * (t + 1) / num_threads;
+            return std::make_pair(begin, end - begin + k - 1);  // Start and length incl. overlap
+        };
+        
+        const uint64_t space = uint64_t(1) << (2 * k);
+        if (space <= kDenseCountingBytes / (sizeof(uint64_t) * num_threads)) {
+            spectrum.count_dense(sequence, k, canonical, num_threads, slice);
+        } else {
+            spectrum.count_partitioned(sequence, k, canonical, num_threads, slice);
+        }
+        for (uint64_t c : spectrum.counts_) spectrum.total_ += c;
+        return spectrum;
+    }
+    
+    int k() const { return k_; }
+    bool canonical() const { return canonical_; }
+    uint64_t total() const { return total_; }
+    size_t distinct() const { return kmers_.size(); }
+    const std::vector<uint64_t>& kmers() const { return kmers_; }
+    const std::vector<uint64_t>& counts() const { return counts_; }
+    
+    /**
+     * Occurrences of one k-mer (canonicalised if the spectrum is canonical)
+     */
+    uint64_t count_of(const std::string& kmer) const {
+        if (static_cast<int>(kmer.size()) != k_) throw std::invalid_argument("k-mer length must equal k");
+        uint64_t code = seqops::encode_kmer(kmer);
+        if (canonical_) {
+            uint64_t rc = 0;
+            for (int i = 0; i < k_; ++i) rc = rc << 2 | (3 - ((code >> (2 * i)) & 3));
+            code = std::min(code, rc);
+        }
+        auto it = std::lower_bound(kmers_.begin(), kmers_.end(), code);
+        return it != kmers_.end() && *it == code ? counts_[it - kmers_.begin()] : 0;
+    }
+    
+    /**
+     * Counts indexed by k-mer code, 4^k entries (k <= 12)
+     */
+    std::vector<uint64_t> dense() const {
+        if (k_ > kMaxDenseK) throw std::invalid_argument("dense output supports k <= 12");
+        std::vector<uint64_t> table(uint64_t(1) << (2 * k_), 0);
+        for (size_t i = 0; i < kmers_.size(); ++i) table[kmers_[i]] = counts_[i];
+        return table;
+    }
+    
+    /**
+     * Abundance histogram: entry c is the number of distinct k-mers seen c
+     * times, for c < max_count; the last entry collects everything above
+     */
+    std::vector<uint64_t> histogram(size_t max_count = 1000) const {
+        std::vector<uint64_t> hist(max_count + 1, 0);
+        for (uint64_t c : counts_) ++hist[std::min<uint64_t>(c, max_count)];
+        return hist;
+    }
+    
+private:
+    /**
+     * Open-addressing (linear probing) k-mer -> count table; key and count
+     * share a slot so a probe touches one cache line
+     */
+    struct Table {
+        static constexpr uint64_t kEmpty = ~uint64_t(0);
+        struct Slot { uint64_t key; uint64_t count; };
+        std::vector<Slot> slots;
+        size_t size = 0;
+        
+        static uint64_t slot(uint64_t key, size_t mask) {
+            key ^= key >> 31;
+            key *= 0x9e3779b97f4a7c15ULL;
+            return (key ^ (key >> 29)) & mask;
+        }
+        
+        void add(uint64_t key, uint64_t count) {
+            if ((size + 1) * 10 > slots.size() * 7) grow();
+            const size_t mask = slots.size() - 1;
+            for (size_t i = slot(key, mask);; i = (i + 1) & mask) {
+                if (slots[i].key == key) { slots[i].count += count; return; }
+                if (slots[i].key == kEmpty) {
+                    slots[i] = {key, count};
+                    ++size;
+                    return;
+                }
+            }
+        }
+        
+        void grow() {
+            std::vector<Slot> old = std::move(slots);
+            slots.assign(std::max<size_t>(256, old.size() * 2), Slot{kEmpty, 0});
+            size = 0;
+            for (const Slot& s : old) {
+                if (s.key != kEmpty) add(s.key, s.count);
+            }
+        }
+    };
+    
+    template <typename Slice>
+    void count_dense(const char* sequence, int k, bool canonical, int num_threads, Slice&& slice) {
+        const uint64_t space = uint64_t(1) << (2 * k);
+        std::vector<std::vector<uint32_t>> local(num_threads);  // Slices are < 2^32 windows per flush
+        std::vector<std::vector<uint64_t>> sums(num_threads);
+        std::vector<std::future<void>> futures;
+        for (int t = 0; t < num_threads; ++t) {
+            futures.push_back(std::async(std::launch::async, [&, t]() {
+                local[t].assign(space, 0);
+                const auto [start, length] = slice(t);
+                uint32_t* counts = local[t].data();
+                // Split very long slices so 32-bit counters cannot overflow
+                const size_t step = size_t(1) << 31;
+                for (size_t offset = 0; offset < length; offset += step) {
+                    const size_t piece = std::min(length - offset, step + k - 1);
+                    seqops::for_each_kmer(sequence + start + offset, piece, k, canonical,
+                                          [counts](size_t, uint64_t kmer) { ++counts[kmer]; });
+                    if (offset + step < length) {
+                        if (sums[t].empty()) sums[t].assign(space, 0);
+                        for (uint64_t i = 0; i < space; ++i) sums[t][i] += counts[i];
+                        std::fill(local[t].begin(), local[t].end(), 0);
+                    }
+                }
+            }));
+        }
+        for (auto& f : futures) f.get();
+        futures.clear();
+        
+        // Sum by index range: each thread owns a disjoint slice of the space
+        std::vector<uint64_t> total(space, 0);
+        for (int t = 0; t < num_threads; ++t) {
+            futures.push_back(std::async(std::launch::async, [&, t]() {
+                for (uint64_t i = space * t / num_threads; i < space * (t + 1) / num_threads; ++i) {
+                    for (int u = 0; u < num_threads; ++u) {
+                        total[i] += local[u][i] + (sums[u].empty() ? 0 : sums[u][i]);
+                    }
+                }
+            }));
+        }
+        for (auto& f : futures) f.get();
+        for (uint64_t i = 0; i < space; ++i) {
+            if (total[i]) {
+                kmers_.push_back(i);
+                counts_.push_back(total[i]);
+            }
+        }
+    }
+    
+    template <typename Slice>
+    void count_partitioned(const char* sequence, int k, bool canonical, int num_threads, Slice&& slice) {
+        // Enough partitions (top bits of the k-mer) that each one's table
+        // stays cache-sized, and several per thread for balance
+        const size_t windows = slice(num_threads - 1).first + slice(num_threads - 1).second - k + 1;
+        const double expected_distinct = std::min(static_cast<double>(windows), std::ldexp(1.0, 2 * k));
+        int partition_bits = 0;
+        while (partition_bits < std::min(2 * k, 16) &&
+               ((1 << partition_bits) < 16 * num_threads || expected_distinct / (1 << partition_bits) > 32768.0)) {
+            ++partition_bits;
+        }
+        const size_t num_partitions = size_t(1) << partition_bits;
+        const int shift = 2 * k - partition_bits;
+        
+        // Phase 1: each thread scatters a batch of k-mers into per-partition
+        // buffers, then folds each buffer into its own table for that
+        // partition, so consecutive inserts hit the same small table
+        std::vector<std::vector<Table>> tables(num_threads, std::vector<Table>(num_partitions));
+        std::vector<std::future<void>> futures;
+        for (int t = 0; t < num_threads; ++t) {
+            futures.push_back(std::async(std::launch::async, [&, t]() {
+                const auto [start, length] = slice(t);
+                std::vector<Table>& mine = tables[t];
+                std::vector<std::vector<uint64_t>> buffers(num_partitions);
+                size_t buffered = 0;
+                auto flush = [&]() {
+                    for (size_t p = 0; p < num_partitions; ++p) {
+                        for (uint64_t kmer : buffers[p]) mine[p].add(kmer, 1);
+                        buffers[p].clear();
+                    }
+                    buffered = 0;
+                };
+                seqops::for_each_kmer(sequence + start, length, k, canonical, [&](size_t, uint64_t kmer) {
+                    buffers[kmer >> shift].push_back(kmer);
+                    if (++buffered == kBatch) flush();
+                });
+                flush();
+            }));
+        }
+        for (auto& f : futures) f.get();
+        futures.clear();
+        
+        // Phase 2: partitions are claimed through an atomic cursor, so each
+        // is merged and sorted by exactly one thread
+        std::vector<std::vector<Table::Slot>> merged(num_partitions);
+        std::atomic<size_t> next{0};
+        for (int t = 0; t < num_threads; ++t) {
+            futures.push_back(std::async(std::launch::async, [&]() {
+                for (size_t p = next++; p < num_partitions; p = next++) {
+                    // Fold the other threads' tables into the largest one
+                    int largest = 0;
+                    for (int u = 1; u < num_threads; ++u) {
+                        if (tables[u][p].size > tables[largest][p].size) largest = u;
+                    }
+                    Table& combined = tables[largest][p];
+                    for (int u = 0; u < num_threads; ++u) {
+                        if (u == largest) continue;
+                        for (const Table::Slot& slot : tables[u][p].slots) {
+                            if (slot.key != Table::kEmpty) combined.add(slot.key, slot.count);
+                        }
+                        tables[u][p] = Table();
+                    }
+                    auto& out = merged[p];
+                    out.reserve(combined.size);
+                    for (const Table::Slot& slot : combined.slots) {
+                        if (slot.key != Table::kEmpty) out.push_back(slot);
+                    }
+                    combined = Table();
+                    std::sort(out.begin(), out.end(),
+                              [](const Table::Slot& a, const Table::Slot& b) { return a.key < b.key; });
+                }
+            }));
+        }
+        for (auto& f : futures) f.get();
+        
+        size_t distinct = 0;
+        for (const auto& part : merged) distinct += part.size();
+        kmers_.reserve(distinct);
+        counts_.reserve(distinct);
+        for (auto& part : merged) {
+            for (const Table::Slot& slot : part) {
+                kmers_.push_back(slot.key);
+                counts_.push_back(slot.count);
+            }
+            std::vector<Table::Slot>().swap(part);
+        }
+    }
+    
+    static constexpr size_t kBatch = size_t(1) << 20;  // k-mers scattered per flush
+    
+    int k_ = 0;
+    bool canonical_ = true;
+    uint64_t total_ = 0;
+    std::vector<uint64_t> kmers_;  // Sorted
+    std::vector<uint64_t> counts_;
+};
+
+/**
+ * Bitset over sequence positions marking low-complexity bases that searches
+ * skip (position i is bit i % 64 of word i / 64). The builders score sliding
+ * windows of valid bases and mask a window whole when it looks repetitive;
+ * non-ACGT bases break windows, and a run of valid bases shorter than the
+ * window is scored once as a whole if it spans at least half a window.
+ */
+class SequenceMask {
+public:
+    explicit SequenceMask(size_t length = 0) : length_(length), words_((length + 63) / 64, 0) {}
+    
+    /**
+     * DUST: mask a window when its triplet score sum c_t (c_t - 1) / 2 / (l - 1)
+     * over its l triplets exceeds threshold / 10 (the dustmasker scale)
+     */
+    static SequenceMask dust(const std::string& sequence, int window = 64, int threshold = 20) {
+        if (window < 4) throw std::invalid_argument("DUST window must be at least 4 bases");
+        if (threshold < 1) throw std::invalid_argument("DUST threshold must be positive");
+        const size_t w = static_cast<size_t>(window);
+        SequenceMask mask(sequence.size());
+        std::array<int, 64> counts{};
+        std::vector<uint8_t> ring(w);  // Triplet ending at position i is ring[i % w]
+        long long score = 0;           // sum of c_t (c_t - 1) / 2
+        size_t run_start = 0;
+        unsigned triplet = 0;
+        
+        auto repetitive = [&](size_t bases) {
+            const long long l = static_cast<long long>(bases) - 2;
+            return score * 10 > static_cast<long long>(threshold) * (l - 1);
+        };
+        for (size_t i = 0; i <= sequence.size(); ++i) {
+            const uint8_t c = i < sequence.size() ? alphabet::code(sequence[i]) : alphabet::kNoCode;
+            if (c == alphabet::kNoCode) {
+                const size_t run = i - run_start;
+                if (run < w && 2 * run >= w && repetitive(run)) mask.set_range(run_start, i);
+                counts.fill(0);
+                score = 0;
+                run_start = i + 1;
+                continue;
+            }
+            triplet = ((triplet << 2) | c) & 63;
+            const size_t run = i - run_start + 1;
+            if (run >= 3) {
+                score += counts[triplet]++;
+                ring[i % w] = static_cast<uint8_t>(triplet);
+            }
+            if (run > w) score -= --counts[ring[(i - w + 2) % w]];  // Triplet that left the window
+            if (run >= w && repetitive(w)) mask.set_range(i + 1 - w, i + 1);
+        }
+        return mask;
+    }
+    
+    /**
+     * Mask a window when the Shannon entropy of its base composition is below
+     * min_entropy bits (2 bits is uniform ACGT; homopolymers score 0 and
+     * dinucleotide repeats 1)
+     */
+    static SequenceMask entropy(const std::string& sequence, int window = 32, double min_entropy = 1.5) {
+        if (window < 4) throw std::invalid_argument("entropy window must be at least 4 bases");
+        const size_t w = static_cast<size_t>(window);
+        SequenceMask mask(sequence.size());
+        std::vector<double> c_log_c(w + 1, 0.0);
+        for (size_t c = 2; c <= w; ++c) c_log_c[c] = c * std::log2(static_cast<double>(c));
+        std::array<size_t, 4> counts{};
+        size_t run_start = 0;
+        
+        auto low_entropy = [&](size_t bases) {
+            double sum = 0.0;
+            for (size_t c : counts) sum += c_log_c[c];
+            return std::log2(static_cast<double>(bases)) - sum / bases < min_entropy;
+        };
+        for (size_t i = 0; i <= sequence.size(); ++i) {
+            const uint8_t c = i < sequence.size() ? alphabet::code(sequence[i]) : alphabet::kNoCode;
+            if (c == alphabet::kNoCode) {
+                const size_t run = i - run_start;
+                if (run < w && 2 * run >= w && low_entropy(run)) mask.set_range(run_start, i);
+                counts.fill(0);
+                run_start = i + 1;
+                continue;
+            }
+            ++counts[c];
+            const size_t run = i - run_start + 1;
+            if (run > w) --counts[alphabet::code(sequence[i - w])];
+            if (run >= w && low_entropy(w)) mask.set_range(i + 1 - w, i + 1);
+        }
+        return mask;
+    }
+    
+    static SequenceMask from_intervals(size_t length, const std::vector<std::pair<size_t, size_t>>& intervals) {
+        SequenceMask mask(length);
+        for (const auto& [begin, end] : intervals) {
+            if (begin > end || end > length) throw std::invalid_argument("mask interval out of range");
+            mask.set_range(begin, end);
+        }
+        return mask;
+    }
+    
+    size_t length() const { return length_; }
+    const std::vector<uint64_t>& words() const { return words_; }
+    
+    bool masked(size_t i) const { return i < length_ && (words_[i / 64] >> (i % 64)) & 1; }
+    
+    size_t masked_bases() const {
+        size_t total = 0;
+        for (uint64_t word : words_) total += bits::popcount64(word);
+        return total;
+    }
+    
+    /**
+     * Whether any of positions [begin, begin + count) is masked
+     */
+    bool any(size_t begin, size_t count) const {
+        const size_t end = std::min(length_, begin + count);
+        return begin < end && next_set(begin, end) < end;
+    }
+    
+    void set_range(size_t begin, size_t end) {
+        end = std::min(end, length_);
+        for (size_t i = begin; i < end;) {
+            const size_t bits = std::min<size_t>(64 - i % 64, end - i);
+            words_[i / 64] |= (bits == 64 ? ~uint64_t(0) : ((uint64_t(1) << bits) - 1)) << (i % 64);
+            i += bits;
+        }
+    }
+    
+    SequenceMask& merge(const SequenceMask& other) {
+        if (other.length_ != length_) throw std::invalid_argument("masks cover different lengths");
+        for (size_t w = 0; w < words_.size(); ++w) words_[w] |= other.words_[w];
+        return *this;
+    }
+    
+    /**
+     * Masked spans as half-open [begin, end) intervals
+     */
+    std::vector<std::pair<size_t, size_t>> intervals() const {
+        std::vector<std::pair<size_t, size_t>> spans;
+        for (size_t i = next_set(0, length_); i < length_;) {
+            const size_t end = next_clear(i, length_);
+            spans.emplace_back(i, end);
+            i = next_set(end, length_);
+        }
+        return spans;
+    }
+    
+    /**
+     * Call fn(a, b) for each maximal unmasked span [a, b) within [begin, end)
+     */
+    template <class F>
+    void for_each_clear_run(size_t begin, size_t end, F&& fn) const {
+        end = std::min(end, length_);
+        for (size_t i = next_clear(begin, end); i < end;) {
+            const size_t stop = next_set(i, end);
+            fn(i, stop);
+            i = next_clear(stop, end);
+        }
+    }
+    
+private:
+    // First position in [i, end) whose bit equals `value`, or end
+    size_t next_bit(size_t i, size_t end, bool value) const {
+        while (i < end) {
+            uint64_t word = words_[i / 64];
+            if (!value) word = ~word;
+            word >>= i % 64;
+            if (word) return std::min(end, i + bits::ctz64(word));
+            i += 64 - i % 64;
+        }
+        return end;
+    }
+    size_t next_set(size_t i, size_t end) const { return next_bit(i, end, true); }
+    size_t next_clear(size_t i, size_t end) const { return next_bit(i, end, false); }
+    
+    size_t length_ = 0;
+    std::vector<uint64_t> words_;
+};
+
+/**
+ * Many sequence records (contigs, chromosomes) held back to back in one
+ * contiguous buffer, with an offset table giving each record's global start.
+ * Searches run per record, so no match can span a record junction, and
+ * hits are reported as (record_id, offset within record).
+ */
+class SequenceCorpus {
 public:
+    SequenceCorpus() : starts_{0} {}
+    
+    SequenceCorpus(const std::vector<std::string>& sequences, const std::vector<std::string>& names) : SequenceCorpus() {
+        if (!names.empty() && names.size() != sequences.size()) {
+            throw std::invalid_argument("names must be empty or match the number of sequences");
+        }
+        size_t total = 0;
+        for (const auto& sequence : sequences) total += sequence.size();
+        data_.reserve(total);
+        for (size_t r = 0; r < sequences.size(); ++r) add(names.empty() ? std::to_string(r) : names[r], sequences[r]);
+    }
+    
+    /**
+     * Load every record of a FASTA file; a record's name is its header up to
+     * the first whitespace. Soft-masked (lowercase) bases are uppercased
+     * unless uppercase is false, so they match uppercase queries.
+     */
+    static SequenceCorpus from_fasta(const std::string& path, bool uppercase = true) {
+        std::ifstream in(path);
+        if (!in) throw std::runtime_error("cannot open FASTA file: " + path);
+        SequenceCorpus corpus;
+        std::string line, name, sequence;
+        bool in_record = false;
+        while (std::getline(in, line)) {
+            if (!line.empty() && line.back() == '\r') line.pop_back();
+            if (!line.empty() && line[0] == '>') {
+                if (in_record) corpus.add(name, sequence);
+                const size_t space = line.find_first_of(" \t");
+                name = line.substr(1, space == std::string::npos ? std::string::npos : space - 1);
+                sequence.clear();
+                in_record = true;
+            } else if (in_record) {
+                if (uppercase) {
+                    for (char& c : line) {
+                        if (c >= 'a' && c <= 'z') c = static_cast<char>(c - 'a' + 'A');
+                    }
+                }
+                sequence += line;
+            } else if (line.find_first_not_of(" \t") != std::string::npos) {
+                throw std::runtime_error("FASTA sequence data before the first header: " + path);
+            }
+        }
+        if (in_record) corpus.add(name, sequence);
+        return corpus;
+    }
+    
+    /**
+     * Corpus over borrowed storage (e.g. a shared-memory mapping) that backing
+     * keeps alive; starts holds names.size() + 1 entries. Copies share the
+     * storage, and the corpus cannot grow.
+     */
+    static SequenceCorpus view(const char* data, const uint64_t* starts, std::vector<std::string> names,
+                               std::shared_ptr<const void> backing) {
+        SequenceCorpus corpus;
+        corpus.view_data_ = data;
+        corpus.view_starts_ = starts;
+        corpus.names_ = std::move(names);
+        corpus.backing_ = std::move(backing);
+        return corpus;
+    }
+    
+    /**
+     * Append a record and return its id
+     */
+    uint32_t add(const std::string& name, const std::string& sequence) {
+        if (backing_) throw std::runtime_error("cannot add records to a read-only corpus");
+        if (names_.size() >= std::numeric_limits<uint32_t>::max()) throw std::length_error("too many records");
+        data_ += sequence;
+        starts_.push_back(data_.size());
+        names_.push_back(name);
+        return static_cast<uint32_t>(names_.size() - 1);
+    }
+    
+    size_t num_records() const { return names_.size(); }
+    size_t total_length() const { return starts()[names_.size()]; }
+    const char* data() const { return backing_ ? view_data_ : data_.data(); }
+    std::string sequence() const { return std::string(data(), total_length()); }
+    const uint64_t* starts() const { return backing_ ? view_starts_ : starts_.data(); }  // num_records() + 1 entries
+    const std::vector<std::string>& names() const { return names_; }
+    bool is_view() const { return backing_ != nullptr; }
+    
+    const std::string& name(uint32_t record) const { return names_.at(record); }
+    uint64_t start(uint32_t record) const { check(record); return starts()[record]; }
+    uint64_t record_length(uint32_t record) const { check(record); return starts()[record + 1] - starts()[record]; }
+    std::string record(uint32_t record) const {
+        check(record);
+        return std::string(data() + starts()[record], starts()[record + 1] - starts()[record]);
+    }
+    
+    /**
+     * Record holding a global position, and the offset within it
+     */
+    std::pair<uint32_t, uint64_t> locate(uint64_t position) const {
+        if (position >= total_length()) throw std::out_of_range("position beyond the end of the corpus");
+        const uint64_t* starts = this->starts();
+        const uint32_t record = static_cast<uint32_t>(std::upper_bound(starts, starts + names_.size() + 1, position) - starts - 1);
+        return {record, position - starts[record]};
+    }
+    
+private:
+    void check(uint32_t record) const {
+        if (record >= names_.size()) throw std::out_of_range("record id out of range");
+    }
+    
+    std::string data_;              // All records, back to back
+    std::vector<uint64_t> starts_;  // Global start of each record, then the total length
+    std::vector<std::string> names_;
+    const char* view_data_ = nullptr;  // Borrowed storage, used instead of data_/starts_ when backing_ is set
+    const uint64_t* view_starts_ = nullptr;
+    std::shared_ptr<const void> backing_;
+};
+
+/**
+ * Corpus search results as parallel arrays, ordered by (record, offset)
+ */
+struct CorpusHits {
+    std::vector<uint32_t> record_ids;
+    std::vector<uint64_t> offsets;
+};
+
+// Arrow C Data and Stream Interface ABI (https://arrow.apache.org/docs/format/CDataInterface.html),
+// declared as the specification asks so the definitions coexist with Arrow's own headers
+#ifndef ARROW_C_DATA_INTERFACE
+#define ARROW_C_DATA_INTERFACE
+#define ARROW_FLAG_DICTIONARY_ORDERED 1
+#define ARROW_FLAG_NULLABLE 2
+#define ARROW_FLAG_MAP_KEYS_SORTED 4
+
+struct ArrowSchema {
+    const char* format;
+    const char* name;
+    const char* metadata;
+    int64_t flags;
+    int64_t n_children;
+    struct ArrowSchema** children;
+    struct ArrowSchema* dictionary;
+    void (*release)(struct ArrowSchema*);
+    void* private_data;
+};
+
+struct ArrowArray {
+    int64_t length;
+    int64_t null_count;
+    int64_t offset;
+    int64_t n_buffers;
+    int64_t n_children;
+    const void** buffers;
+    struct ArrowArray** children;
+    struct ArrowArray* dictionary;
+    void (*release)(struct ArrowArray*);
+    void* private_data;
+};
+#endif
+
+#ifndef ARROW_C_STREAM_INTERFACE
+#define ARROW_C_STREAM_INTERFACE
+struct ArrowArrayStream {
+    int (*get_schema)(struct ArrowArrayStream*, struct ArrowSchema* out);
+    int (*get_next)(struct ArrowArrayStream*, struct ArrowArray* out);
+    const char* (*get_last_error)(struct ArrowArrayStream*);
+    void (*release)(struct ArrowArrayStream*);
+    void* private_data;
+};
+#endif
+
+/**
+ * Match results as columns (record_id, position, strand, score, mismatches),
+ * exportable through the Arrow C Data Interface without copying: exported
+ * arrays point into the columns and share their ownership, so the table and
+ * any Arrow consumer can outlive each other. Rows are ordered by (record,
+ * position, strand). Positions are 0-based leftmost forward-strand
+ * coordinates within the record; strand is +1 or -1; score is the fraction
+ * of pattern bases matched.
+ */
+class MatchTable {
+public:
+    struct Columns {
+        std::vector<uint32_t> record_ids;
+        std::vector<uint64_t> positions;
+        std::vector<int8_t> strands;
+        std::vector<float> scores;
+        std::vector<uint16_t> mismatches;
+    };
+    
+    static constexpr int kNumColumns = 5;
+    static constexpr const char* kNames[kNumColumns] = {"record_id", "position", "strand", "score", "mismatches"};
+    static constexpr const char* kFormats[kNumColumns] = {"I", "L", "c", "f", "S"};  // uint32 uint64 int8 float32 uint16
+    
+    MatchTable() : columns_(std::make_shared<Columns>()) {}
+    
+    /**
+     * Exact hits on one strand; takes over the hit arrays without copying
+     */
+    static MatchTable from_hits(CorpusHits&& hits, int8_t strand) {
+        MatchTable table;
+        Columns& c = *table.columns_;
+        const size_t n = hits.offsets.size();
+        c.record_ids = std::move(hits.record_ids);
+        c.positions = std::move(hits.offsets);
+        c.strands.assign(n, strand);
+        c.scores.assign(n, 1.0f);
+        c.mismatches.assign(n, 0);
+        return table;
+    }
+    
+    /**
+     * Exact hits of a pattern (forward) and of its reverse complement,
+     * merged into row order
+     */
+    static MatchTable from_strands(const CorpusHits& forward, const CorpusHits& reverse) {
+        MatchTable table;
+        Columns& c = *table.columns_;
+        const size_t n = forward.offsets.size() + reverse.offsets.size();
+        c.record_ids.resize(n);
+        c.positions.resize(n);
+        c.strands.resize(n);
+        c.scores.assign(n, 1.0f);
+        c.mismatches.assign(n, 0);
+        size_t f = 0, r = 0;
+        for (size_t row = 0; row < n; ++row) {
+            const bool take_forward = r == reverse.offsets.size() ||
+                (f < forward.offsets.size() &&
+                 std::make_pair(forward.record_ids[f], forward.offsets[f]) <= std::make_pair(reverse.record_ids[r], reverse.offsets[r]));
+            const CorpusHits& source = take_forward ? forward : reverse;
+            size_t& i = take_forward ? f : r;
+            c.record_ids[row] = source.record_ids[i];
+            c.positions[row] = source.offsets[i];
+            c.strands[row] = take_forward ? 1 : -1;
+            ++i;
+        }
+        return table;
+    }
+    
+    size_t size() const { return columns_->positions.size(); }
+    const Columns& columns() const { return *columns_; }
+    std::shared_ptr<const Columns> share() const { return columns_; }
+    
+    void append(uint32_t record_id, uint64_t position, int8_t strand, float score, uint16_t mismatches) {
+        unshare();
+        Columns& c = *columns_;
+        c.record_ids.push_back(record_id);
+        c.positions.push_back(position);
+        c.strands.push_back(strand);
+        c.scores.push_back(score);
+        c.mismatches.push_back(mismatches);
+    }
+    
+    /**
+     * Schema of the exported struct array, one non-nullable child per column
+     */
+    static void export_schema(ArrowSchema* out) {
+        struct Holder {
+            ArrowSchema children[kNumColumns];
+            ArrowSchema* pointers[kNumColumns];
+        };
+        auto* holder = new Holder;
+        for (int i = 0; i < kNumColumns; ++i) {
+            holder->children[i] = {kFormats[i], kNames[i], nullptr, 0, 0, nullptr, nullptr,
+                                   [](ArrowSchema* child) { child->release = nullptr; }, nullptr};
+            holder->pointers[i] = &holder->children[i];
+        }
+        *out = {"+s", "", nullptr, 0, kNumColumns, holder->pointers, nullptr, [](ArrowSchema* schema) {
+            for (int i = 0; i < kNumColumns; ++i) {
+                if (schema->children[i]->release) schema->children[i]->release(schema->children[i]);
+            }
+            delete static_cast<Holder*>(schema->private_data);
+            schema->release = nullptr;
+        }, holder};
+    }
+    
+    /**
+     * The table as one struct array; every child keeps the columns alive
+     * itself, so consumers may move children out
+     */
+    void export_array(ArrowArray* out) const {
+        struct Child {
+            std::shared_ptr<const Columns> columns;
+            const void* buffers[2];
+        };
+        struct Holder {
+            const void* buffers[1] = {nullptr};
+            ArrowArray children[kNumColumns];
+            ArrowArray* pointers[kNumColumns];
+        };
+        static const uint64_t kEmpty = 0;  // Valid address for the data of empty columns
+        const Columns& c = *columns_;
+        const void* data[kNumColumns] = {c.record_ids.data(), c.positions.data(), c.strands.data(),
+                                         c.scores.data(), c.mismatches.data()};
+        const int64_t length = static_cast<int64_t>(size());
+        auto* holder = new Holder;
+        for (int i = 0; i < kNumColumns; ++i) {
+            auto* child = new Child{columns_, {nullptr, data[i] ? data[i] : &kEmpty}};
+            holder->children[i] = {length, 0, 0, 2, 0, child->buffers, nullptr, nullptr, [](ArrowArray* array) {
+                delete static_cast<Child*>(array->private_data);
+                array->release = nullptr;
+            }, child};
+            holder->pointers[i] = &holder->children[i];
+        }
+        *out = {length, 0, 0, 1, kNumColumns, holder->buffers, holder->pointers, nullptr, [](ArrowArray* array) {
+            for (int i = 0; i < kNumColumns; ++i) {
+                if (array->children[i]->release) array->children[i]->release(array->children[i]);
+            }
+            delete static_cast<Holder*>(array->private_data);
+            array->release = nullptr;
+        }, holder};
+    }
+    
+    /**
+     * A stream yielding the table as a single batch
+     */
+    void export_stream(ArrowArrayStream* out) const {
+        struct Holder {
+            MatchTable table;
+            bool done = false;
+        };
+        out->get_schema = [](ArrowArrayStream*, ArrowSchema* schema) {
+            export_schema(schema);
+            return 0;
+        };
+        out->get_next = [](ArrowArrayStream* stream, ArrowArray* array) {
+            auto* holder = static_cast<Holder*>(stream->private_data);
+            if (holder->done) {
+                array->release = nullptr;  // End of stream
+            } else {
+                holder->table.export_array(array);
+                holder->done = true;
+            }
+            return 0;
+        };
+        out->get_last_error = [](ArrowArrayStream*) -> const char* { return nullptr; };
+        out->release = [](ArrowArrayStream* stream) {
+            delete static_cast<Holder*>(stream->private_data);
+            stream->release = nullptr;
+        };
+        out->private_data = new Holder{*this};
+    }
+    
+private:
+    // Copy on write, so appending never changes columns already exported
+    void unshare() {
+        if (columns_.use_count() > 1) columns_ = std::make_shared<Columns>(*columns_);
+    }
+    
+    std::shared_ptr<Columns> columns_;
+};
+
+/**
+ * Aho-Corasick automaton over a set of patterns, compiled to a dense DFA on
+ * the bytes the patterns use (every other byte shares one symbol), so a scan
+ * costs one table lookup per base however many patterns there are. Duplicate
+ * patterns share a state; each reports under its own id.
+ */
+class AhoCorasick {
+public:
+    explicit AhoCorasick(const std::vector<std::string>& patterns) : lengths_(patterns.size()) {
+        symbol_.fill(0);
+        num_symbols_ = 1;
+        for (const auto& pattern : patterns) {
+            if (pattern.empty()) throw std::invalid_argument("patterns must not be empty");
+            for (unsigned char c : pattern) {
+                if (symbol_[c] == 0) symbol_[c] = static_cast<uint8_t>(num_symbols_++);
+            }
+        }
+        
+        // Trie, with kNone for missing edges
+        add_state();
+        for (size_t p = 0; p < patterns.size(); ++p) {
+            uint32_t state = 0;
+            for (unsigned char c : patterns[p]) {
+                const size_t edge = state * num_symbols_ + symbol_[c];
+                if (next_[edge] == kNone) {
+                    const uint32_t child = add_state();  // Grows next_, so index it only afterwards
+                    next_[edge] = child;
+                }
+                state = next_[edge];
+            }
+            lengths_[p] = static_cast<uint32_t>(patterns[p].size());
+            outputs_[state].push_back(static_cast<uint32_t>(p));
+        }
+        
+        // Breadth-first failure links, filling missing edges to make a DFA
+        std::vector<uint32_t> fail(outputs_.size(), 0), queue;
+        for (int s = 0; s < num_symbols_; ++s) {
+            uint32_t& edge = next_[s];
+            if (edge == kNone) {
+                edge = 0;
+            } else {
+                queue.push_back(edge);
+            }
+        }
+        for (size_t head = 0; head < queue.size(); ++head) {
+            const uint32_t state = queue[head];
+            output_link_[state] = outputs_[fail[state]].empty() ? output_link_[fail[state]] : fail[state];
+            for (int s = 0; s < num_symbols_; ++s) {
+                uint32_t& edge = next_[state * num_symbols_ + s];
+                if (edge == kNone) {
+                    edge = next_[fail[state] * num_symbols_ + s];
+                } else {
+                    fail[edge] = next_[fail[state] * num_symbols_ + s];
+                    queue.push_back(edge);
+                }
+            }
+        }
+    }
+    
+    size_t num_patterns() const { return lengths_.size(); }
+    size_t pattern_length(size_t pattern) const { return lengths_[pattern]; }
+    size_t num_states() const { return outputs_.size(); }
+    
+    /**
+     * Feed text[begin, limit) from the root and call on_match(pattern, start)
+     * for every match that starts before end; matches are reported in order
+     * of their last base
+     */
+    template <typename F>
+    void scan(const char* text, size_t begin, size_t end, size_t limit, F&& on_match) const {
+        uint32_t state = 0;
+        for (size_t i = begin; i < limit; ++i) {
+            state = next_[state * num_symbols_ + symbol_[static_cast<unsigned char>(text[i])]];
+            for (uint32_t s = outputs_[state].empty() ? output_link_[state] : state; s != kNone; s = output_link_[s]) {
+                for (uint32_t p : outputs_[s]) {
+                    const size_t start = i + 1 - lengths_[p];
+                    if (start < end) on_match(p, start);
+                }
+            }
+        }
+    }
+    
+private:
+    static constexpr uint32_t kNone = ~uint32_t(0);
+    
+    uint32_t add_state() {
+        next_.resize(next_.size() + num_symbols_, kNone);
+        outputs_.emplace_back();
+        output_link_.push_back(kNone);
+        return static_cast<uint32_t>(outputs_.size() - 1);
+    }
+    
+    std::array<uint8_t, 256> symbol_;
+    int num_symbols_;
+    std::vector<uint32_t> next_;                   // State * num_symbols_ + symbol -> state
+    std::vector<std::vector<uint32_t>> outputs_;   // Patterns ending exactly at each state
+    std::vector<uint32_t> output_link_;            // Nearest proper suffix state with outputs, or kNone
+    std::vector<uint32_t> lengths_;
+};
+
+/**
+ * Persistent worker threads with one task deque each. A batch of task
+ * indices is dealt to the deques in contiguous blocks; each worker pops its
+ * own tasks from the back and, once empty, steals from the front of the
+ * others', so uneven tasks balance themselves. run() blocks until every task
+ * of its batch has finished, rethrowing the batch's first exception; batches
+ * from concurrent callers share the workers and complete independently.
+ */
+class WorkStealingPool {
+public:
+    explicit WorkStealingPool(int num_threads) : queues_(std::max(1, num_threads)) {
+        for (size_t w = 0; w < queues_.size(); ++w) {
+            workers_.emplace_back([this, w]() { work(w); });
+        }
+    }
+    
+    ~WorkStealingPool() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stopping_ = true;
+        }
+        wake_.notify_all();
+        for (auto& worker : workers_) worker.join();
+    }
+    
+    WorkStealingPool(const WorkStealingPool&) = delete;
+    WorkStealingPool& operator=(const WorkStealingPool&) = delete;
+    
+    int size() const { return static_cast<int>(queues_.size()); }
+    
+    /**
+     * Run fn(task) for every task in [0, num_tasks)
+     */
+    void run(size_t num_tasks, const std::function<void(size_t)>& fn) {
+        if (num_tasks == 0) return;
+        // Counted in full before any task is visible: a worker still draining
+        // an earlier batch may pick these up at once
+        Batch batch{&fn, num_tasks, nullptr};
+        const size_t W = queues_.size();
+        for (size_t w = 0; w < W; ++w) {
+            std::lock_guard<std::mutex> lock(queues_[w].mutex);
+            for (size_t t = num_tasks * w / W; t < num_tasks * (w + 1) / W; ++t) queues_[w].tasks.push_back({&batch, t});
+        }
+        std::unique_lock<std::mutex> lock(mutex_);
+        ++generation_;
+        wake_.notify_all();
+        done_.wait(lock, [&batch]() { return batch.pending == 0; });
+        if (batch.error) std::rethrow_exception(batch.error);
+    }
+    
+private:
+    // Each task points at its own batch's function and counter (guarded by
+    // mutex_), so tasks of different batches never touch each other's state
+    struct Batch {
+        const std::function<void(size_t)>* fn;
+        size_t pending;
+        std::exception_ptr error;
+    };
+    using Task = std::pair<Batch*, size_t>;
+    
+    struct Queue {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+    };
+    
+    bool next_task(size_t self, Task& task) {
+        {
+            std::lock_guard<std::mutex> lock(queues_[self].mutex);
+            if (!queues_[self].tasks.empty()) {
+                task = queues_[self].tasks.back();
+                queues_[self].tasks.pop_back();
+                return true;
+            }
+        }
+        for (size_t i = 1; i < queues_.size(); ++i) {
+            Queue& victim = queues_[(self + i) % queues_.size()];
+            std::lock_guard<std::mutex> lock(victim.mutex);
+            if (!victim.tasks.empty()) {
+                task = victim.tasks.front();
+                victim.tasks.pop_front();
+                return true;
+            }
+        }
+        return false;
+    }
+    
+    void work(size_t self) {
+        uint64_t seen = 0;
+        for (;;) {
+            {
+                std::unique_lock<std::mutex> lock(mutex_);
+                wake_.wait(lock, [&]() { return stopping_ || generation_ != seen; });
+                if (stopping_) return;
+                seen = generation_;
+            }
+            Task task;
+            while (next_task(self, task)) {
+                Batch& batch = *task.first;
+                std::exception_ptr error;
+                try {
+                    (*batch.fn)(task.second);
+                } catch (...) {
+                    error = std::current_exception();
+                }
+                // The caller may return and free the batch once pending hits
+                // zero, so this is the last touch
+                std::lock_guard<std::mutex> lock(mutex_);
+                if (error && !batch.error) batch.error = error;
+                if (--batch.pending == 0) done_.notify_all();
+            }
+        }
+    }
+    
+    std::vector<Queue> queues_;
+    std::vector<std::thread> workers_;
+    std::mutex mutex_;
+    std::condition_variable wake_;
+    std::condition_variable done_;
+    uint64_t generation_ = 0;  // Bumped per batch to wake idle workers
+    bool stopping_ = false;
+};
+
+/**
+ * FIFO of independent jobs run by a fixed set of threads, backing the *_async
+ * entry points. Jobs that parallelise internally fan out on a WorkStealingPool,
+ * not on these threads, so a job never waits on the threads it occupies;
+ * concurrent jobs may share one pool, whose batches complete independently.
+ */
+class AsyncExecutor {
+public:
+    explicit AsyncExecutor(int num_threads) {
+        for (int t = 0; t < std::max(1, num_threads); ++t) {
+            threads_.emplace_back([this]() { work(); });
+        }
+    }
+    
+    ~AsyncExecutor() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stopping_ = true;
+        }
+        wake_.notify_all();
+        for (auto& thread : threads_) thread.join();
+    }
+    
+    AsyncExecutor(const AsyncExecutor&) = delete;
+    AsyncExecutor& operator=(const AsyncExecutor&) = delete;
+    
+    int size() const { return static_cast<int>(threads_.size()); }
+    
+    void submit(std::function<void()> job) {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            jobs_.push_back(std::move(job));
+        }
+        wake_.notify_one();
+    }
+    
+    /**
+     * Process-wide executor with one thread per hardware thread (at least two).
+     * Never destroyed: jobs may still be finishing while the interpreter exits.
+     */
+    static AsyncExecutor& shared() {
+        static AsyncExecutor* executor = new AsyncExecutor(std::max(2u, std::thread::hardware_concurrency()));
+        return *executor;
+    }
+    
+private:
+    void work() {
+        for (;;) {
+            std::function<void()> job;
+            {
+                std::unique_lock<std::mutex> lock(mutex_);
+                wake_.wait(lock, [this]() { return stopping_ || !jobs_.empty(); });
+                if (jobs_.empty()) return;  // Stopping, queue drained
+                job = std::move(jobs_.front());
+                jobs_.pop_front();
+            }
+            job();
+        }
+    }
+    
+    std::vector<std::thread> threads_;
+    std::deque<std::function<void()>> jobs_;
+    std::mutex mutex_;
+    std::condition_variable wake_;
+    bool stopping_ = false;
+};
+
+/**
+ * Machine-specific search parameters, calibrated once and kept in a profile
+ * file ($GROVER_TUNING_PROFILE, else ~/.cache/grover_accelerator/tuning.txt)
+ * of "key=value" lines. A profile from a machine with a different CPU count
+ * is ignored and recalibrated.
+ */
+namespace tuning {
+    constexpr int kVersion = 1;
+    
+    struct Profile {
+        int cpus = 1;                        // Hardware threads when calibrated
+        int scan_threads = 1;                // Fastest thread count for a large scan
+        uint64_t scan_parallel_threshold = ~uint64_t(0);  // Bases from which the parallel scan wins
+        uint64_t scan_min_chunk = 1 << 16;   // Fewest bases worth giving one scan thread
+        uint64_t corpus_task_windows = 1 << 16;  // Window starts per corpus task
+        double scan_serial_mbps = 0.0;       // Serial scan throughput, for reference
+        std::string source;                  // "file" or "calibrated"
+    };
+    
+    std::mutex profile_mutex;
+    
+    std::unique_ptr<Profile>& cached() {
+        static std::unique_ptr<Profile> profile;
+        return profile;
+    }
+    
+    int hardware_threads() {
+        return std::max(1u, std::thread::hardware_concurrency());
+    }
+    
+    std::string profile_path() {
+        if (const char* path = std::getenv("GROVER_TUNING_PROFILE"); path && *path) return path;
+        std::string base;
+        if (const char* cache = std::getenv("XDG_CACHE_HOME"); cache && *cache) {
+            base = cache;
+        } else if (const char* home = std::getenv("HOME"); home && *home) {
+            base = std::string(home) + "/.cache";
+        } else {
+            return "";
+        }
+        return base + "/grover_accelerator/tuning.txt";
+    }
+    
+    bool load(const std::string& path, Profile& profile) {
+        std::ifstream in(path);
+        if (!in) return false;
+        std::unordered_map<std::string, std::string> values;
+        std::string line;
+        while (std::getline(in, line)) {
+            const size_t eq = line.find('=');
+            if (line.empty() || line[0] == '#' || eq == std::string::npos) continue;
+            values[line.substr(0, eq)] = line.substr(eq + 1);
+        }
+        try {
+            if (std::stoi(values.at("version")) != kVersion) return false;
+            profile.cpus = std::stoi(values.at("cpus"));
+            profile.scan_threads = std::stoi(values.at("scan_threads"));
+            profile.scan_parallel_threshold = std::stoull(values.at("scan_parallel_threshold"));
+            profile.scan_min_chunk = std::stoull(values.at("scan_min_chunk"));
+            profile.corpus_task_windows = std::stoull(values.at("corpus_task_windows"));
+            profile.scan_serial_mbps = std::stod(values.at("scan_serial_mbps"));
+        } catch (const std::exception&) {
+            return false;  // Missing or malformed entries: recalibrate
+        }
+        profile.source = "file";
+        return profile.cpus == hardware_threads() && profile.scan_threads >= 1 && profile.corpus_task_windows > 0;
+    }
+    
+    /**
+     * Best-effort write; an unwritable location only costs a recalibration
+     */
+    void save(const std::string& path, const Profile& profile) {
+        if (path.empty()) return;
+        std::error_code ignored;
+        const std::filesystem::path parent = std::filesystem::path(path).parent_path();
+        if (!parent.empty()) std::filesystem::create_directories(parent, ignored);
+        // Unique per writer, so concurrent processes never share a temp file
+        const std::string tmp = path + ".tmp" + std::to_string(std::random_device{}()) +
+                                std::to_string(std::chrono::steady_clock::now().time_since_epoch().count());
+        {
+            std::ofstream out(tmp);
+            if (!out) return;
+            out << "# grover_accelerator tuning profile\n"
+                << "version=" << kVersion << "\n"
+                << "cpus=" << profile.cpus << "\n"
+                << "scan_threads=" << profile.scan_threads << "\n"
+                << "scan_parallel_threshold=" << profile.scan_parallel_threshold << "\n"
+                << "scan_min_chunk=" << profile.scan_min_chunk << "\n"
+                << "corpus_task_windows=" << profile.corpus_task_windows << "\n"
+                << "scan_serial_mbps=" << profile.scan_serial_mbps << "\n";
+            if (!out) return;
+        }
+        std::rename(tmp.c_str(), path.c_str());  // Readers never see a partial file
+    }
+    
+    /**
+     * Best of `repeats` wall-clock timings of fn(), in seconds
+     */
+    template <class F>
+    double best_time(int repeats, F&& fn) {
+        double best = std::numeric_limits<double>::infinity();
+        for (int r = 0; r < repeats; ++r) {
+            const auto start = std::chrono::steady_clock::now();
+            fn();
+            best = std::min(best, std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+        }
+        return best;
+    }
+}
+
+/**
+ * NUMA topology discovery and thread placement helpers
+ */
+namespace numa {
+    struct Topology {
+        std::vector<std::vector<int>> node_cpus;  // Usable CPUs of each node
+    };
+
+    /**
+     * Parse a sysfs CPU list such as "0-7,16-23"
+     */
+    std::vector<int> parse_cpu_list(const std::string& list) {
+        std::vector<int> cpus;
+        size_t pos = 0;
+        while (pos < list.size()) {
+            size_t comma = list.find(',', pos);
+            if (comma == std::string::npos) comma = list.size();
+            std::string range = list.substr(pos, comma - pos);
+            size_t dash = range.find('-');
+            try {
+                if (dash == std::string::npos) {
+                    cpus.push_back(std::stoi(range));
+                } else {
+                    int first = std::stoi(range.substr(0, dash));
+                    int last = std::stoi(range.substr(dash + 1));
+                    for (int cpu = first; cpu <= last; ++cpu) cpus.push_back(cpu);
+                }
+            } catch (const std::exception&) {
+                // Ignore malformed entries (trailing newline, empty list)
+            }
+            pos = comma + 1;
+        }
+        return cpus;
+    }
+
+    /**
+     * Discover NUMA nodes from sysfs, restricted to the CPUs this process may
+     * run on. Falls back to a single node spanning the allowed CPUs (all
+     * hardware threads where there is no affinity mask).
+     */
+    const Topology& topology() {
+        static const Topology topo = [] {
+            Topology t;
+#ifdef __linux__
+            cpu_set_t allowed;
+            CPU_ZERO(&allowed);
+            const bool have_mask = sched_getaffinity(0, sizeof(allowed), &allowed) == 0;
+            for (int node = 0;; ++node) {
+                std::ifstream in("/sys/devices/system/node/node" + std::to_string(node) + "/cpulist");
+                if (!in) break;
+                std::string list;
+                std::getline(in, list);
+                std::vector<int> cpus;
+                for (int cpu : parse_cpu_list(list)) {
+                    if (!have_mask || (cpu < CPU_SETSIZE && CPU_ISSET(cpu, &allowed))) {
+                        cpus.push_back(cpu);
+                    }
+                }
+                if (!cpus.empty()) t.node_cpus.push_back(cpus);
+            }
+#endif
+            if (t.node_cpus.empty()) {
+                std::vector<int> cpus;
+#ifdef __linux__
+                if (have_mask) {
+                    for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+                        if (CPU_ISSET(cpu, &allowed)) cpus.push_back(cpu);
+                    }
+                }
+#endif
+                if (cpus.empty()) {
+                    const int hw = std::max(1u, std::thread::hardware_concurrency());
+                    for (int i = 0; i < hw; ++i) cpus.push_back(i);
+                }
+                t.node_cpus.push_back(cpus);
+            }
+            return t;
+        }();
+        return topo;
+    }
+
+    /**
+     * Node owning worker `worker`: workers are laid out in contiguous blocks,
+     * so chunk t of a partitioned buffer lives on node t * nodes / workers
+     */
+    int node_for_worker(int worker, int num_workers) {
+        int nodes = static_cast<int>(topology().node_cpus.size());
+        return static_cast<int>(static_cast<long long>(worker) * nodes / num_workers);
+    }
+
+    int cpu_for_worker(int worker, int num_workers) {
+        int node = node_for_worker(worker, num_workers);
+        int nodes = static_cast<int>(topology().node_cpus.size());
+        // Index of this worker within its node's block
+        int first = (node * num_workers + nodes - 1) / nodes;
+        const auto& cpus = topology().node_cpus[node];
+        return cpus[(worker - first) % cpus.size()];
+    }
+
+    /**
+     * Pin the calling thread to a single CPU. Returns false where unsupported.
+     */
+    bool pin_current_thread(int cpu) {
+#ifdef __linux__
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        CPU_SET(cpu, &set);
+        return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+#else
+        (void)cpu;
+        return false;
+#endif
+    }
+}
+
+/**
+ * Large-buffer allocation with optional huge-page backing
+ *
+ * Modes:
+ *   "off"         - plain heap allocation
+ *   "transparent" - anonymous mmap + madvise(MADV_HUGEPAGE)
+ *   "2M" / "1G"   - explicit hugetlbfs pages (MAP_HUGETLB), falling back to
+ *                   transparent huge pages when the pool is exhausted
+ */
+namespace memory {
+    struct HugePageConfig {
+        std::string mode = "transparent";
+        size_t threshold = size_t(2) << 20;  // Allocations below this use the heap
+    };
+
+    enum class Backing { Heap, Mapped, HugeTlb, File };
+
+    struct Stats {
+        std::atomic<size_t> large_allocations{0};
+        std::atomic<size_t> huge_page_allocations{0};  // Guaranteed hugetlbfs mappings
+        std::atomic<size_t> transparent_requests{0};   // MADV_HUGEPAGE accepted; backing not guaranteed
+        std::atomic<size_t> bytes_mapped{0};
+        std::atomic<size_t> last_page_size{0};
+    };
+
+    std::mutex config_mutex;
+
+    HugePageConfig& config() {
+        static HugePageConfig cfg;
+        return cfg;
+    }
+
+    Stats& stats() {
+        static Stats s;
+        return s;
+    }
+
+    size_t base_page_size() {
+#if defined(__unix__) || defined(__APPLE__)
+        return static_cast<size_t>(sysconf(_SC_PAGESIZE));
+#else
+        return 4096;
+#endif
+    }
+
+    /**
+     * Huge page size the kernel will use for MADV_HUGEPAGE regions, or 0 when
+     * transparent huge pages are disabled
+     */
+    size_t transparent_huge_page_size() {
+#ifdef __linux__
+        static const size_t size = [] {
+            std::ifstream enabled("/sys/kernel/mm/transparent_hugepage/enabled");
+            std::string setting;
+            std::getline(enabled, setting);
+            if (!enabled || setting.find("[never]") != std::string::npos) return size_t(0);
+            std::ifstream pmd("/sys/kernel/mm/transparent_hugepage/hpage_pmd_size");
+            size_t bytes = 0;
+            pmd >> bytes;
+            return bytes ? bytes : size_t(2) << 20;
+        }();
+        return size;
+#else
+        return 0;
+#endif
+    }
+
+    /**
+     * Bytes of this process currently backed by transparent huge pages
+     */
+    size_t anon_huge_bytes() {
+#ifdef __linux__
+        std::ifstream in("/proc/self/smaps_rollup");
+        std::string line;
+        while (std::getline(in, line)) {
+            if (line.rfind("AnonHugePages:", 0) == 0) {
+                return std::stoull(line.substr(14)) * 1024;
+            }
+        }
+#endif
+        return 0;
+    }
+
+    void set_huge_pages(const std::string& mode, size_t threshold) {
+        if (mode != "off" && mode != "transparent" && mode != "2M" && mode != "1G") {
+            throw std::invalid_argument("mode must be 'off', 'transparent', '2M' or '1G'");
+        }
+        std::lock_guard<std::mutex> lock(config_mutex);
+        config().mode = mode;
+        config().threshold = threshold;
+    }
+
+    /**
+     * Allocate `bytes` of uninitialised memory. Pages are not touched, so the
+     * first writer decides NUMA placement. Reports the page size guaranteed
+     * for the block and how it must be released; a transparent huge page
+     * request only asks the kernel, so it keeps the base page size and is
+     * counted separately (see anon_huge_bytes for what was actually obtained).
+     * `page_aligned` maps blocks below the threshold too, instead of taking
+     * them from the (unaligned) heap.
+     */
+    void* allocate(size_t bytes, size_t& page_size, Backing& backing, bool page_aligned = false) {
+        HugePageConfig cfg;
+        {
+            std::lock_guard<std::mutex> lock(config_mutex);
+            cfg = config();
+        }
+        page_size = base_page_size();
+        backing = Backing::Heap;
+        bytes = std::max<size_t>(bytes, 1);
+        
+#if defined(__unix__) || defined(__APPLE__)
+        if (cfg.mode != "off" && bytes >= cfg.threshold) {
+            void* p = MAP_FAILED;
+#ifdef MAP_HUGETLB
+            if (cfg.mode == "2M" || cfg.mode == "1G") {
+                const size_t huge = cfg.mode == "2M" ? size_t(2) << 20 : size_t(1) << 30;
+                const int shift = cfg.mode == "2M" ? 21 : 30;
+                const size_t rounded = (bytes + huge - 1) / huge * huge;
+                p = mmap(nullptr, rounded, PROT_READ | PROT_WRITE,
+                         MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB | (shift << MAP_HUGE_SHIFT), -1, 0);
+                if (p != MAP_FAILED) {
+                    page_size = huge;
+                    backing = Backing::HugeTlb;
+                    bytes = rounded;
+                }
+            }
+#endif
+            if (p == MAP_FAILED) {
+                p = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+                backing = Backing::Mapped;
+#ifdef MADV_HUGEPAGE
+                if (p != MAP_FAILED && transparent_huge_page_size() > 0 &&
+                    madvise(p, bytes, MADV_HUGEPAGE) == 0) {
+                    stats().transparent_requests++;
+                }
+#endif
+            }
+            if (p != MAP_FAILED) {
+                stats().large_allocations++;
+                stats().bytes_mapped += bytes;
+                stats().last_page_size = page_size;
+                if (page_size > base_page_size()) stats().huge_page_allocations++;
+                return p;
+            }
+        }
+#endif
+        backing = Backing::Heap;
+        page_size = base_page_size();
+#if defined(__unix__) || defined(__APPLE__)
+        if (page_aligned) {
+            void* p = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+            if (p == MAP_FAILED) throw std::bad_alloc();
+            backing = Backing::Mapped;
+            stats().bytes_mapped += bytes;
+            return p;
+        }
+#else
+        (void)page_aligned;
+#endif
+        void* p = std::malloc(bytes);
+        if (!p) throw std::bad_alloc();
+        return p;
+    }
+
+    /**
+     * Map `bytes` of a new scratch file in `directory` (typically on local
+     * NVMe). The file gets a fresh unique name, so nothing existing is ever
+     * overwritten, and is unlinked at once, so it disappears with the
+     * mapping. Access is advised as sequential for streaming kernels.
+     */
+    void* map_file(const std::string& directory, size_t bytes, size_t& page_size, Backing& backing) {
+#if defined(__unix__) || defined(__APPLE__)
+        bytes = std::max<size_t>(bytes, 1);
+        struct stat info;
+        if (stat(directory.c_str(), &info) != 0 || !S_ISDIR(info.st_mode)) {
+            throw std::invalid_argument("storage path must be an existing directory: " + directory);
+        }
+        std::string path = directory + "/grover_amplitudes_XXXXXX";
+        int fd = mkstemp(&path[0]);
+        if (fd < 0) throw std::runtime_error("cannot create a storage file in " + directory);
+        unlink(path.c_str());
+        if (ftruncate(fd, static_cast<off_t>(bytes)) != 0) {
+            close(fd);
+            throw std::runtime_error("cannot size storage file in " + directory);
+        }
+        void* p = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        close(fd);
+        if (p == MAP_FAILED) throw std::runtime_error("cannot map storage file in " + directory);
+        madvise(p, bytes, MADV_SEQUENTIAL);
+        page_size = base_page_size();
+        backing = Backing::File;
+        stats().bytes_mapped += bytes;
+        return p;
+#else
+        (void)directory; (void)bytes; (void)page_size; (void)backing;
+        throw std::runtime_error("file-backed storage requires mmap");
+#endif
+    }
+
+    /**
+     * Ask the kernel to start reading a range ahead of use (readahead)
+     */
+    void prefetch(const void* p, size_t bytes) {
+#if defined(__unix__) || defined(__APPLE__)
+        const uintptr_t page = base_page_size();
+        uintptr_t begin = reinterpret_cast<uintptr_t>(p) & ~(page - 1);
+        uintptr_t end = reinterpret_cast<uintptr_t>(p) + bytes;
+        madvise(reinterpret_cast<void*>(begin), end - begin, MADV_WILLNEED);
+#else
+        (void)p; (void)bytes;
+#endif
+    }
+
+    /**
+     * Mark a finished range as first in line for reclaim
+     */
+    void retire(const void* p, size_t bytes) {
+#if defined(__linux__) && defined(MADV_COLD)
+        const uintptr_t page = base_page_size();
+        uintptr_t begin = (reinterpret_cast<uintptr_t>(p) + page - 1) & ~(page - 1);
+        uintptr_t end = (reinterpret_cast<uintptr_t>(p) + bytes) & ~(page - 1);
+        if (end > begin) madvise(reinterpret_cast<void*>(begin), end - begin, MADV_COLD);
+#else
+        (void)p; (void)bytes;
+#endif
+    }
+
+    void release(void* p, size_t bytes, size_t page_size, Backing backing) {
+        if (!p) return;
+#if defined(__unix__) || defined(__APPLE__)
+        if (backing != Backing::Heap) {
+            bytes = std::max<size_t>(bytes, 1);
+            if (backing == Backing::HugeTlb) {
+                bytes = (bytes + page_size - 1) / page_size * page_size;
+            }
+            munmap(p, bytes);
+            stats().bytes_mapped -= bytes;
+            return;
+        }
+#endif
+        (void)bytes;
+        (void)page_size;
+        (void)backing;
+        std::free(p);
+    }
+}
+
+/**
+ * Move-only array of trivially copyable T backed by memory::allocate.
+ * Elements are left uninitialised.
+ */
+template <typename T>
+class PageBuffer {
+public:
+    PageBuffer() = default;
+    /**
+     * `page_aligned` starts the buffer on a page boundary even below the
+     * huge-page threshold, where it would otherwise come from the heap
+     */
+    explicit PageBuffer(size_t count, bool page_aligned = false) : size_(count) {
+        data_ = static_cast<T*>(memory::allocate(count * sizeof(T), page_size_, backing_, page_aligned));
+    }
+    
+    /**
+     * Buffer stored in a memory-mapped scratch file in `directory` instead of RAM
+     */
+    static PageBuffer mapped_file(const std::string& directory, size_t count) {
+        PageBuffer buffer;
+        buffer.size_ = count;
+        buffer.data_ = static_cast<T*>(memory::map_file(directory, count * sizeof(T), buffer.page_size_, buffer.backing_));
+        return buffer;
+    }
+    
+    bool file_backed() const { return backing_ == memory::Backing::File; }
+    ~PageBuffer() { memory::release(data_, size_ * sizeof(T), page_size_, backing_); }
+    
+    PageBuffer(PageBuffer&& other) noexcept { swap(other); }
+    PageBuffer& operator=(PageBuffer&& other) noexcept {
+        PageBuffer tmp(std::move(other));
+        swap(tmp);
+        return *this;
+    }
+    PageBuffer(const PageBuffer&) = delete;
+    PageBuffer& operator=(const PageBuffer&) = delete;
+    
+    T* data() { return data_; }
+    const T* data() const { return data_; }
+    size_t size() const { return size_; }
+    size_t page_size() const { return page_size_; }
+    T& operator[](size_t i) { return data_[i]; }
+    const T& operator[](size_t i) const { return data_[i]; }
+    
+private:
+    void swap(PageBuffer& other) noexcept {
+        std::swap(data_, other.data_);
+        std::swap(size_, other.size_);
+        std::swap(page_size_, other.page_size_);
+        std::swap(backing_, other.backing_);
+    }
+    
+    T* data_ = nullptr;
+    size_t size_ = 0;
+    size_t page_size_ = 0;
+    memory::Backing backing_ = memory::Backing::Heap;
+};
+
+/**
+ * Sequence buffer whose pages are first-touched by pinned worker threads, so
+ * that a later parallel scan with the same layout reads node-local memory.
+ *
+ * Policies:
+ *   "partition"  - worker t owns one contiguous, page-aligned chunk
+ *   "interleave" - pages are dealt round-robin to workers (bandwidth spread)
+ */
+class PlacedSequence {
+public:
+    PlacedSequence(const std::string& sequence, int num_threads = 4, const std::string& policy = "partition")
+        : length_(sequence.length()), num_threads_(std::max(1, num_threads)), policy_(policy) {
+        if (policy_ != "partition" && policy_ != "interleave") {
+            throw std::invalid_argument("policy must be 'partition' or 'interleave'");
+        }
+        
+        // PageBuffer leaves pages untouched, so the pinned workers below
+        // decide which node each page is placed on; page-aligned even when
+        // small, so chunk boundaries fall on page boundaries
+        data_ = PageBuffer<char>(length_, true);
+        
+        const size_t page_size = memory::base_page_size();
+        const size_t pages = (length_ + page_size - 1) / page_size;
+        bounds_.resize(num_threads_ + 1);
+        for (int t = 0; t <= num_threads_; ++t) {
+            bounds_[t] = std::min(length_, (pages * t / num_threads_) * page_size);
+        }
+        bounds_[num_threads_] = length_;
+        
+        std::vector<std::thread> workers;
+        for (int t = 0; t < num_threads_; ++t) {
+            workers.emplace_back([this, &sequence, t, pages, page_size]() {
+                numa::pin_current_thread(numa::cpu_for_worker(t, num_threads_));
+                if (policy_ == "partition") {
+                    std::copy(sequence.begin() + bounds_[t], sequence.begin() + bounds_[t + 1],
+                              data_.data() + bounds_[t]);
+                } else {
+                    for (size_t page = t; page < pages; page += num_threads_) {
+                        size_t begin = page * page_size;
+                        size_t end = std::min(length_, begin + page_size);
+                        std::copy(sequence.begin() + begin, sequence.begin() + end, data_.data() + begin);
+                    }
+                }
+            });
+        }
+        for (auto& worker : workers) {
+            worker.join();
+        }
+    }
+    
+    const char* data() const { return data_.data(); }
+    size_t length() const { return length_; }
+    size_t page_size() const { return data_.page_size(); }
+    int num_threads() const { return num_threads_; }
+    const std::string& policy() const { return policy_; }
+    
+    /**
+     * First byte owned by worker t (partition policy); bounds(num_threads) == length
+     */
+    size_t bounds(int t) const { return bounds_[t]; }
+    
+    /**
+     * NUMA node each worker is placed on
+     */
+    std::vector<int> worker_nodes() const {
+        std::vector<int> nodes(num_threads_);
+        for (int t = 0; t < num_threads_; ++t) {
+            nodes[t] = numa::node_for_worker(t, num_threads_);
+        }
+        return nodes;
+    }
+    
+private:
+    PageBuffer<char> data_;
+    size_t length_;
+    int num_threads_;
+    std::string policy_;
+    std::vector<size_t> bounds_;
+};
+
+/**
+ * Bitstring label for a basis state, most significant qubit first (the same
+ * layout as encode_positions and the trimmed Qiskit counts)
+ */
+std::string basis_state_label(uint64_t index, int n_qubits) {
+    std::string label(n_qubits, '0');
+    for (int bit = 0; bit < n_qubits; ++bit) {
+        if ((index >> bit) & 1) label[n_qubits - 1 - bit] = '1';
+    }
+    return label;
+}
+
+/**
+ * Draw `shots` samples from |amplitudes|^2 over a block of basis states whose
+ * probabilities sum to `mass`. Sorted uniforms let a single sweep over the
+ * block serve every shot without materialising a CDF.
+ */
+std::vector<std::pair<uint64_t, int>> sample_amplitudes(const std::complex<double>* amplitudes, size_t count,
+                                                        uint64_t first_index, double mass, int shots,
+                                                        std::mt19937_64& rng) {
+    std::vector<std::pair<uint64_t, int>> samples;
+    if (shots <= 0 || count == 0 || mass <= 0.0) return samples;
+    
+    std::uniform_real_distribution<double> uniform(0.0, mass);
+    std::vector<double> draws(shots);
+    for (auto& draw : draws) draw = uniform(rng);
+    std::sort(draws.begin(), draws.end());
+    
+    double cumulative = 0.0;
+    size_t last_nonzero = 0;
+    size_t i = 0;
+    for (size_t k = 0; k < count && i < draws.size(); ++k) {
+        double p = std::norm(amplitudes[k]);
+        if (p <= 0.0) continue;
+        last_nonzero = k;
+        cumulative += p;
+        int hits = 0;
+        while (i < draws.size() && draws[i] < cumulative) {
+            ++hits;
+            ++i;
+        }
+        if (hits) samples.emplace_back(first_index + k, hits);
+    }
+    // Rounding can leave the largest draws past the final cumulative sum
+    if (i < draws.size()) {
+        int rest = static_cast<int>(draws.size() - i);
+        if (!samples.empty() && samples.back().first == first_index + last_nonzero) {
+            samples.back().second += rest;
+        } else {
+            samples.emplace_back(first_index + last_nonzero, rest);
+        }
+    }
+    return samples;
+}
+
+/**
+ * Statevector kernels specialised on the qubit count. Grover searches over
+ * reads mostly need 6-16 qubits; with the dimension a compile-time constant
+ * every loop has a fixed trip count the compiler unrolls and vectorises, and
+ * states of up to 2^11 amplitudes (32 KiB) are worked on in an L1-resident
+ * stack copy. iteration_kernel(n) dispatches from the runtime qubit count and
+ * returns nullptr above kMaxQubits, where the generic path takes over.
+ */
+namespace kernels {
+    constexpr int kMaxQubits = 16;
+    constexpr uint64_t kMaxLocalAmplitudes = uint64_t(1) << 11;
+    
+    using IterationKernel = void (*)(std::complex<double>*, const std::vector<int>&, int);
+    
+    /**
+     * Four-lane sum so the reduction vectorises without reassociation flags
+     */
+    template <uint64_t D>
+    inline std::complex<double> sum(const std::complex<double>* a) {
+        constexpr uint64_t kLanes = D < 4 ? D : 4;
+        double re[kLanes] = {}, im[kLanes] = {};
+        for (uint64_t i = 0; i < D; i += kLanes) {
+            for (uint64_t l = 0; l < kLanes; ++l) {
+                re[l] += a[i + l].real();
+                im[l] += a[i + l].imag();
+            }
+        }
+        std::complex<double> total(0.0, 0.0);
+        for (uint64_t l = 0; l < kLanes; ++l) total += std::complex<double>(re[l], im[l]);
+        return total;
+    }
+    
+    /**
+     * `iterations` fused Grover iterations on a 2^N statevector: one
+     * reflection pass per iteration. Reflection about the mean preserves the
+     * amplitude sum, so only the sparse oracle flips update it.
+     */
+    template <int N>
+    void grover_iterations(std::complex<double>* state, const std::vector<int>& marked, int iterations) {
+        constexpr uint64_t D = uint64_t(1) << N;
+        constexpr bool kLocal = D <= kMaxLocalAmplitudes;
+        alignas(64) std::complex<double> local[kLocal ? D : 1];
+        std::complex<double>* a = state;
+        if constexpr (kLocal) {
+            std::copy(state, state + D, local);
+            a = local;
+        }
+        
+        for (int m : marked) a[m] = -a[m];
+        std::complex<double> total = sum<D>(a);
+        for (int k = 0; k < iterations; ++k) {
+            const std::complex<double> twice_mean = 2.0 * total / static_cast<double>(D);
+            for (uint64_t i = 0; i < D; ++i) a[i] = twice_mean - a[i];
+            if (k + 1 < iterations) {
+                for (int m : marked) {
+                    total -= 2.0 * a[m];
+                    a[m] = -a[m];
+                }
+            }
+        }
+        
+        if constexpr (kLocal) std::copy(local, local + D, state);
+    }
+    
+    template <int... Ns>
+    constexpr std::array<IterationKernel, sizeof...(Ns)> make_table(std::integer_sequence<int, Ns...>) {
+        return {&grover_iterations<Ns + 1>...};
+    }
+    
+    inline IterationKernel iteration_kernel(int n_qubits) {
+        static constexpr auto table = make_table(std::make_integer_sequence<int, kMaxQubits>{});
+        return n_qubits >= 1 && n_qubits <= kMaxQubits ? table[n_qubits - 1] : nullptr;
+    }
+}
+
+/**
+ * Noise applied by trajectory simulation. Depolarizing and amplitude-damping
+ * channels act on every qubit after each oracle and each diffusion layer;
+ * readout error flips each measured bit independently.
+ */
+struct NoiseModel {
+    double depolarizing = 0.0;       // Probability of a random X/Y/Z per qubit per layer
+    double amplitude_damping = 0.0;  // Decay probability gamma per qubit per layer
+    double readout_error = 0.0;      // Bit-flip probability per measured bit
+    
+    NoiseModel() = default;
+    NoiseModel(double depolarizing, double amplitude_damping, double readout_error)
+        : depolarizing(depolarizing), amplitude_damping(amplitude_damping), readout_error(readout_error) {
+        for (double p : {depolarizing, amplitude_damping, readout_error}) {
+            if (p < 0.0 || p > 1.0) throw std::invalid_argument("noise probabilities must be in [0, 1]");
+        }
+    }
+};
+
+/**
+ * Native statevector simulator for Grover search over 2^n basis states.
+ * The oracle phase-flips the marked states; diffusion reflects about the mean.
+ *
+ * Under that oracle and diffusion every marked amplitude stays equal to every
+ * other, and likewise for the unmarked ones, so the state starts compressed:
+ * two amplitudes plus the marked set, making each iteration O(1). Operations
+ * that break the symmetry (a non-uniform phase oracle, noise) expand it to a
+ * full statevector first.
+ *
+ * With a storage path (a directory) the expanded amplitudes live in a
+ * memory-mapped scratch file created there (out-of-core mode) and kernels
+ * stream it block by block with readahead.
+ */
+class GroverSimulator {
+public:
+    static constexpr uint64_t kBlock = uint64_t(1) << 20;  // Amplitudes per streamed block (16 MiB)
+    
+    GroverSimulator(int n_qubits, const std::vector<int>& marked, const std::string& storage_path = "",
+                    bool compressed = true)
+        : n_qubits_(n_qubits), storage_path_(storage_path) {
+        if (n_qubits < 1 || n_qubits > 40) {
+            throw std::invalid_argument("n_qubits must be between 1 and 40");
+        }
+        dimension_ = uint64_t(1) << n_qubits;
+        for (int m : marked) {
+            if (m >= 0 && static_cast<uint64_t>(m) < dimension_) marked_.push_back(m);
+        }
+        std::sort(marked_.begin(), marked_.end());
+        marked_.erase(std::unique(marked_.begin(), marked_.end()), marked_.end());
+        
+        reset();
+        if (!compressed) expand();
+    }
+    
+    int n_qubits() const { return n_qubits_; }
+    uint64_t dimension() const { return dimension_; }
+    const std::vector<int>& marked() const { return marked_; }
+    bool out_of_core() const { return amplitudes_.file_backed(); }
+    bool is_compressed() const { return compressed_; }
+    
+    /**
+     * Iteration kernel in use: "compressed", "specialized" or "generic"
+     */
+    std::string kernel() const {
+        if (compressed_) return "compressed";
+        if (!amplitudes_.file_backed() && kernels::iteration_kernel(n_qubits_)) return "specialized";
+        return "generic";
+    }
+    
+    /**
+     * Prepare the uniform superposition H^n|0>
+     */
+    void reset() {
+        const std::complex<double> uniform(1.0 / std::sqrt(static_cast<double>(dimension_)), 0.0);
+        marked_amplitude_ = unmarked_amplitude_ = uniform;
+        if (compressed_) return;
+        stream([&](uint64_t begin, uint64_t end) {
+            std::fill(amplitudes_.data() + begin, amplitudes_.data() + end, uniform);
+        });
+    }
+    
+    /**
+     * Switch to the full statevector representation
+     */
+    void expand() {
+        if (!compressed_) return;
+        if (amplitudes_.size() != dimension_) {
+            if (storage_path_.empty()) {
+                amplitudes_ = PageBuffer<std::complex<double>>(dimension_);
+            } else {
+                amplitudes_ = PageBuffer<std::complex<double>>::mapped_file(storage_path_, dimension_);
+            }
+        }
+        const std::complex<double> unmarked = unmarked_amplitude_;
+        stream([&](uint64_t begin, uint64_t end) {
+            std::fill(amplitudes_.data() + begin, amplitudes_.data() + end, unmarked);
+        });
+        for (int m : marked_) amplitudes_[m] = marked_amplitude_;
+        compressed_ = false;
+    }
+    
+    void apply_oracle() {
+        if (compressed_) {
+            marked_amplitude_ = -marked_amplitude_;
+            return;
+        }
+        for (int m : marked_) {
+            amplitudes_[m] = -amplitudes_[m];
+        }
+    }
+    
+    /**
+     * User-supplied diagonal oracle. Stays compressed when the diagonal is
+     * constant over the marked set and over the unmarked set; otherwise the
+     * state is expanded.
+     */
+    void apply_phase_oracle(const std::vector<std::complex<double>>& diagonal) {
+        if (diagonal.size() != dimension_) {
+            throw std::invalid_argument("diagonal must have 2^n_qubits entries");
+        }
+        if (compressed_) {
+            std::complex<double> on_marked, on_unmarked;
+            bool seen_marked = false, seen_unmarked = false, symmetric = true;
+            size_t next_marked = 0;
+            for (uint64_t i = 0; i < dimension_ && symmetric; ++i) {
+                const bool is_marked = next_marked < marked_.size() && static_cast<uint64_t>(marked_[next_marked]) == i;
+                if (is_marked) {
+                    ++next_marked;
+                    if (!seen_marked) { on_marked = diagonal[i]; seen_marked = true; }
+                    else symmetric = diagonal[i] == on_marked;
+                } else {
+                    if (!seen_unmarked) { on_unmarked = diagonal[i]; seen_unmarked = true; }
+                    else symmetric = diagonal[i] == on_unmarked;
+                }
+            }
+            if (symmetric) {
+                if (seen_marked) marked_amplitude_ *= on_marked;
+                if (seen_unmarked) unmarked_amplitude_ *= on_unmarked;
+                return;
+            }
+            expand();
+        }
+        stream([&](uint64_t begin, uint64_t end) {
+            for (uint64_t i = begin; i < end; ++i) amplitudes_[i] *= diagonal[i];
+        });
+    }
+    
+    /**
+     * Pauli 'X', 'Y' or 'Z' on one qubit (expands the state)
+     */
+    void apply_pauli(int qubit, char pauli) {
+        expand();
+        const uint64_t bit = uint64_t(1) << qubit;
+        const std::complex<double> i_unit(0.0, 1.0);
+        std::complex<double>* a = amplitudes_.data();
+        for (uint64_t i = 0; i < dimension_; ++i) {
+            if (i & bit) continue;
+            const uint64_t j = i | bit;
+            switch (pauli) {
+                case 'X': std::swap(a[i], a[j]); break;
+                case 'Y': { std::complex<double> a0 = a[i]; a[i] = -i_unit * a[j]; a[j] = i_unit * a0; break; }
+                case 'Z': a[j] = -a[j]; break;
+                default: throw std::invalid_argument("pauli must be 'X', 'Y' or 'Z'");
+            }
+        }
+    }
+    
+    /**
+     * One quantum-trajectory step of amplitude damping on `qubit`. With
+     * probability gamma * P(qubit = 1) (decided by the uniform draw `u`) the
+     * qubit decays to |0>; otherwise the no-jump operator diag(1, sqrt(1-gamma))
+     * is applied. The state is renormalised. Returns true on a jump.
+     */
+    bool apply_amplitude_damping(int qubit, double gamma, double u) {
+        expand();
+        const uint64_t bit = uint64_t(1) << qubit;
+        std::complex<double>* a = amplitudes_.data();
+        double excited = 0.0, total = 0.0;
+        for (uint64_t i = 0; i < dimension_; ++i) {
+            const double p = std::norm(a[i]);
+            total += p;
+            if (i & bit) excited += p;
+        }
+        const double p_jump = gamma * excited / total;
+        const bool jump = u < p_jump;
+        const double keep = std::sqrt(1.0 - gamma);
+        const double scale = 1.0 / std::sqrt(jump ? gamma * excited : total - p_jump * total);
+        for (uint64_t i = 0; i < dimension_; ++i) {
+            if (i & bit) continue;
+            const uint64_t j = i | bit;
+            if (jump) {
+                a[i] = std::sqrt(gamma) * a[j] * scale;
+                a[j] = 0.0;
+            } else {
+                a[i] *= scale;
+                a[j] *= keep * scale;
+            }
+        }
+        return jump;
+    }
+    
+    /**
+     * Inversion about the mean, 2|s><s| - I
+     */
+    void apply_diffusion() {
+        if (compressed_) {
+            reflect_compressed();
+            return;
+        }
+        reflect_about_mean(sum_amplitudes());
+    }
+    
+    /**
+     * Apply Grover iterations. Expanded, each iteration is one streaming pass:
+     * the amplitude sum needed by the next diffusion is accumulated while the
+     * current one writes, then corrected for the oracle's sparse sign flips.
+     * In-memory states of up to kernels::kMaxQubits qubits use the kernel
+     * specialised for their size.
+     */
+    void iterate(int iterations) {
+        if (iterations <= 0) return;
+        if (compressed_) {
+            for (int k = 0; k < iterations; ++k) {
+                marked_amplitude_ = -marked_amplitude_;
+                reflect_compressed();
+            }
+            return;
+        }
+        if (!amplitudes_.file_backed()) {
+            if (kernels::IterationKernel kernel = kernels::iteration_kernel(n_qubits_)) {
+                kernel(amplitudes_.data(), marked_, iterations);
+                return;
+            }
+        }
+        apply_oracle();
+        std::complex<double> sum = sum_amplitudes();
+        for (int k = 0; k < iterations; ++k) {
+            sum = reflect_about_mean(sum);
+            if (k + 1 < iterations) {
+                for (int m : marked_) {
+                    sum -= 2.0 * amplitudes_[m];
+                    amplitudes_[m] = -amplitudes_[m];
+                }
+            }
+        }
+    }
+    
+    /**
+     * Generalized iteration S_s(diffusion_phase) S_t(oracle_phase): marked
+     * states pick up e^{i oracle_phase}, then the |s> component picks up
+     * e^{i diffusion_phase}. Both phases pi is the standard iteration up to a
+     * global sign.
+     */
+    void apply_generalized_iteration(double oracle_phase, double diffusion_phase) {
+        const std::complex<double> oracle = std::polar(1.0, oracle_phase);
+        const std::complex<double> shift = 1.0 - std::polar(1.0, diffusion_phase);
+        const double N = static_cast<double>(dimension_);
+        if (compressed_) {
+            marked_amplitude_ *= oracle;
+            const double num_marked = static_cast<double>(marked_.size());
+            const std::complex<double> mean = (num_marked * marked_amplitude_ + (N - num_marked) * unmarked_amplitude_) / N;
+            marked_amplitude_ -= shift * mean;
+            unmarked_amplitude_ -= shift * mean;
+            return;
+        }
+        for (int m : marked_) amplitudes_[m] *= oracle;
+        const std::complex<double> correction = shift * sum_amplitudes() / N;
+        stream([&](uint64_t begin, uint64_t end) {
+            std::complex<double>* a = amplitudes_.data();
+            for (uint64_t i = begin; i < end; ++i) a[i] -= correction;
+        });
+    }
+    
+    /**
+     * Exact Grover (Long's phase matching): K = ceil(pi/(4 theta) - 1/2)
+     * iterations, all with phase phi = 2 asin(sin(pi/(4K+2)) / sin theta), rotate
+     * |s> exactly onto the marked subspace. Returns (K, phi).
+     */
+    static std::pair<int, double> exact_schedule(uint64_t dimension, uint64_t num_marked) {
+        if (num_marked == 0 || num_marked > dimension) {
+            throw std::invalid_argument("exact Grover needs 0 < num_marked <= dimension");
+        }
+        const double theta = std::asin(std::sqrt(static_cast<double>(num_marked) / static_cast<double>(dimension)));
+        const int K = std::max(0, static_cast<int>(std::ceil(M_PI / (4.0 * theta) - 0.5)));
+        if (K == 0) return {0, M_PI};
+        const double ratio = std::min(1.0, std::sin(M_PI / (4.0 * K + 2.0)) / std::sin(theta));
+        return {K, 2.0 * std::asin(ratio)};
+    }
+    
+    /**
+     * Fixed-point amplitude amplification (Yoder, Low & Chuang): the shortest
+     * odd query count L = 2l + 1 whose phases (alpha_j, beta_j) guarantee
+     * success >= 1 - delta^2 for every marked fraction >= min_fraction.
+     * Returns the l (oracle_phase, diffusion_phase) pairs in application order.
+     */
+    static std::vector<std::pair<double, double>> fixed_point_schedule(double delta, double min_fraction) {
+        if (!(delta > 0.0 && delta < 1.0)) {
+            throw std::invalid_argument("delta must be in (0, 1)");
+        }
+        if (!(min_fraction > 0.0 && min_fraction <= 1.0)) {
+            throw std::invalid_argument("min_fraction must be in (0, 1]");
+        }
+        // gamma^-1 = T_{1/L}(1/delta); the guarantee holds for fractions >= 1 - gamma^2
+        int L = 1;
+        double gamma = 0.0;
+        for (;; L += 2) {
+            gamma = 1.0 / std::cosh(std::acosh(1.0 / delta) / L);
+            if (1.0 - gamma * gamma <= min_fraction) break;
+        }
+        const int l = (L - 1) / 2;
+        const double root = std::sqrt(1.0 - gamma * gamma);
+        std::vector<double> alpha(l + 1);
+        for (int j = 1; j <= l; ++j) {
+            alpha[j] = 2.0 * std::atan2(1.0, std::tan(2.0 * M_PI * j / L) * root);  // 2 acot(.)
+        }
+        std::vector<std::pair<double, double>> phases;
+        for (int j = 1; j <= l; ++j) {
+            // beta_j = -alpha_{l-j+1} on the oracle; the paper's S_s(alpha) carries e^{-i alpha}
+            phases.emplace_back(-alpha[l - j + 1], -alpha[j]);
+        }
+        return phases;
+    }
+    
+    /**
+     * Reset, run exact Grover for the marked set and sample
+     */
+    std::unordered_map<std::string, int> run_exact(int shots = 1000, uint64_t seed = 42) {
+        const auto [iterations, phase] = exact_schedule(dimension_, marked_.size());
+        reset();
+        for (int k = 0; k < iterations; ++k) apply_generalized_iteration(phase, phase);
+        return sample(shots, seed);
+    }
+    
+    /**
+     * Reset, run fixed-point amplification and sample; success is at least
+     * 1 - delta^2 whenever the marked fraction is >= min_fraction
+     */
+    std::unordered_map<std::string, int> run_fixed_point(double delta, double min_fraction, int shots = 1000,
+                                                         uint64_t seed = 42) {
+        reset();
+        for (const auto& [oracle_phase, diffusion_phase] : fixed_point_schedule(delta, min_fraction)) {
+            apply_generalized_iteration(oracle_phase, diffusion_phase);
+        }
+        return sample(shots, seed);
+    }
+    
+    std::vector<double> probabilities() const {
+        std::vector<double> probs(dimension_);
+        if (compressed_) {
+            std::fill(probs.begin(), probs.end(), std::norm(unmarked_amplitude_));
+            for (int m : marked_) probs[m] = std::norm(marked_amplitude_);
+            return probs;
+        }
+        stream([&](uint64_t begin, uint64_t end) {
+            for (uint64_t i = begin; i < end; ++i) probs[i] = std::norm(amplitudes_[i]);
+        });
+        return probs;
+    }
+    
+    /**
+     * Total probability of measuring a marked state
+     */
+    double success_probability() const {
+        if (compressed_) return marked_.size() * std::norm(marked_amplitude_);
+        double p = 0.0;
+        for (int m : marked_) p += std::norm(amplitudes_[m]);
+        return p;
+    }
+    
+    /**
+     * Measure all qubits `shots` times; keys use the same bitstrings as run()
+     */
+    std::unordered_map<std::string, int> sample(int shots, uint64_t seed = 42) const {
+        std::mt19937_64 rng(seed);
+        std::unordered_map<std::string, int> counts;
+        
+        if (compressed_) {
+            const uint64_t num_marked = marked_.size();
+            const double marked_mass = num_marked * std::norm(marked_amplitude_);
+            const double unmarked_mass = (dimension_ - num_marked) * std::norm(unmarked_amplitude_);
+            std::uniform_real_distribution<double> uniform(0.0, marked_mass + unmarked_mass);
+            for (int s = 0; s < shots; ++s) {
+                uint64_t index;
+                if (num_marked == dimension_ || (num_marked > 0 && uniform(rng) < marked_mass)) {
+                    index = marked_[std::uniform_int_distribution<uint64_t>(0, num_marked - 1)(rng)];
+                } else {
+                    // r-th unmarked state: skip over the marked states at or below it
+                    const uint64_t r = std::uniform_int_distribution<uint64_t>(0, dimension_ - num_marked - 1)(rng);
+                    index = r;
+                    for (;;) {
+                        uint64_t below = std::upper_bound(marked_.begin(), marked_.end(), index,
+                                                          [](uint64_t v, int m) { return v < static_cast<uint64_t>(m); })
+                                         - marked_.begin();
+                        if (r + below == index) break;
+                        index = r + below;
+                    }
+                }
+                counts[basis_state_label(index, n_qubits_)]++;
+            }
+            return counts;
+        }
+        
+        double mass = 0.0;
+        stream([&](uint64_t begin, uint64_t end) {
+            for (uint64_t i = begin; i < end; ++i) mass += std::norm(amplitudes_[i]);
+        });
+        for (const auto& [index, hits] : sample_amplitudes(amplitudes_.data(), dimension_, 0, mass, shots, rng)) {
+            counts[basis_state_label(index, n_qubits_)] += hits;
+        }
+        return counts;
+    }
+    
+    /**
+     * Reset, apply `iterations` Grover iterations and sample
+     */
+    std::unordered_map<std::string, int> run(int iterations, int shots = 1000, uint64_t seed = 42) {
+        reset();
+        iterate(iterations);
+        return sample(shots, seed);
+    }
+    
+private:
+    /**
+     * Visit the statevector in blocks; out of core, the next block is
+     * prefetched while the current one is processed and then retired
+     */
+    template <typename F>
+    void stream(F&& fn) const {
+        const bool file_backed = amplitudes_.file_backed();
+        for (uint64_t begin = 0; begin < dimension_; begin += kBlock) {
+            const uint64_t end = std::min(dimension_, begin + kBlock);
+            if (file_backed && end < dimension_) {
+                memory::prefetch(amplitudes_.data() + end,
+                                 std::min(kBlock, dimension_ - end) * sizeof(std::complex<double>));
+            }
+            fn(begin, end);
+            if (file_backed) {
+                memory::retire(amplitudes_.data() + begin, (end - begin) * sizeof(std::complex<double>));
+            }
+        }
+    }
+    
+    std::complex<double> sum_amplitudes() const {
+        std::complex<double> sum(0.0, 0.0);
+        stream([&](uint64_t begin, uint64_t end) {
+            for (uint64_t i = begin; i < end; ++i) sum += amplitudes_[i];
+        });
+        return sum;
+    }
+    
+    /**
+     * a -> 2*mean - a given the current amplitude sum; returns the new sum
+     */
+    std::complex<double> reflect_about_mean(std::complex<double> sum) {
+        const std::complex<double> twice_mean = 2.0 * sum / static_cast<double>(dimension_);
+        std::complex<double> new_sum(0.0, 0.0);
+        stream([&](uint64_t begin, uint64_t end) {
+            std::complex<double>* a = amplitudes_.data();
+            for (uint64_t i = begin; i < end; ++i) {
+                a[i] = twice_mean - a[i];
+                new_sum += a[i];
+            }
+        });
+        return new_sum;
+    }
+    
+    void reflect_compressed() {
+        const double num_marked = static_cast<double>(marked_.size());
+        const std::complex<double> twice_mean =
+            2.0 * (num_marked * marked_amplitude_ + (static_cast<double>(dimension_) - num_marked) * unmarked_amplitude_) /
+            static_cast<double>(dimension_);
+        marked_amplitude_ = twice_mean - marked_amplitude_;
+        unmarked_amplitude_ = twice_mean - unmarked_amplitude_;
+    }
+    
+    int n_qubits_;
+    uint64_t dimension_;
+    std::vector<int> marked_;  // Sorted, unique, < dimension
+    std::string storage_path_;
+    
+    // Compressed form: one amplitude shared by all marked states, one by the rest
+    bool compressed_ = true;
+    std::complex<double> marked_amplitude_;
+    std::complex<double> unmarked_amplitude_;
+    
+    PageBuffer<std::complex<double>> amplitudes_;  // Expanded form
+};
+
+/**
+ * MPI-style communicator used by the distributed simulator: rank/size,
+ * barrier and an in-place sum allreduce with MPI_Allreduce semantics.
+ */
+class Communicator {
+public:
+    virtual ~Communicator() = default;
+    virtual int rank() const = 0;
+    virtual int size() const = 0;
+    virtual void barrier() = 0;
+    virtual void allreduce_sum(double* data, int count) = 0;
+};
+
+#if defined(__unix__) || defined(__APPLE__)
+/**
+ * Communicator for ranks on one host, exchanging data through a named POSIX
+ * shared-memory segment. The creator initialises the segment; every rank
+ * (including the creator's children) attaches to it by name.
+ */
+class ShmCommunicator : public Communicator {
+public:
+    static constexpr int kMaxRanks = 64;
+    static constexpr int kSlotDoubles = 64;  // Allreduce payload per round
+    
+    /**
+     * Create and initialise the segment for `size` ranks; does not join it
+     */
+    static void create_segment(const std::string& name, int size) {
+        if (size < 1 || size > kMaxRanks) {
+            throw std::invalid_argument("number of ranks must be between 1 and 64");
+        }
+        int fd = shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+        if (fd < 0) throw std::runtime_error("shm_open failed for " + name);
+        if (ftruncate(fd, sizeof(Segment)) != 0) {
+            close(fd);
+            shm_unlink(name.c_str());
+            throw std::runtime_error("ftruncate failed for " + name);
+        }
+        void* p = mmap(nullptr, sizeof(Segment), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        close(fd);
+        if (p == MAP_FAILED) {
+            shm_unlink(name.c_str());
+            throw std::runtime_error("mmap failed for " + name);
+        }
+        Segment* seg = new (p) Segment();
+        seg->size = size;
+        munmap(p, sizeof(Segment));
+    }
+    
+    static void remove_segment(const std::string& name) {
+        shm_unlink(name.c_str());
+    }
+    
+    ShmCommunicator(const std::string& name, int rank) : rank_(rank) {
+        int fd = shm_open(name.c_str(), O_RDWR, 0600);
+        if (fd < 0) throw std::runtime_error("shm_open failed for " + name);
+        void* p = mmap(nullptr, sizeof(Segment), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        close(fd);
+        if (p == MAP_FAILED) throw std::runtime_error("mmap failed for " + name);
+        segment_ = static_cast<Segment*>(p);
+        if (rank < 0 || rank >= segment_->size) {
+            munmap(p, sizeof(Segment));
+            throw std::invalid_argument("rank out of range");
+        }
+    }
+    
+    ~ShmCommunicator() override {
+        munmap(segment_, sizeof(Segment));
+    }
+    
+    ShmCommunicator(const ShmCommunicator&) = delete;
+    ShmCommunicator& operator=(const ShmCommunicator&) = delete;
+    
+    int rank() const override { return rank_; }
+    int size() const override { return segment_->size; }
+    
+    /**
+     * Sense-reversing barrier over process-shared atomics
+     */
+    void barrier() override {
+        local_sense_ = !local_sense_;
+        if (segment_->arrived.fetch_add(1) + 1 == segment_->size) {
+            segment_->arrived.store(0);
+            segment_->sense.store(local_sense_);
+        } else {
+            while (segment_->sense.load() != local_sense_) {
+                if (segment_->aborted.load()) _exit(1);
+                sched_yield();
+            }
+        }
+    }
+    
+    void allreduce_sum(double* data, int count) override {
+        for (int offset = 0; offset < count; offset += kSlotDoubles) {
+            const int n = std::min(kSlotDoubles, count - offset);
+            std::copy(data + offset, data + offset + n, segment_->slots[rank_]);
+            barrier();
+            for (int i = 0; i < n; ++i) {
+                double sum = 0.0;
+                for (int r = 0; r < segment_->size; ++r) sum += segment_->slots[r][i];
+                data[offset + i] = sum;
+            }
+            barrier();  // Slots may be reused by the next round
+        }
+    }
+    
+    /**
+     * Release every rank spinning in barrier() (used when a peer has died)
+     */
+    void abort() { segment_->aborted.store(true); }
+    
+private:
+    struct Segment {
+        int size = 0;
+        std::atomic<int> arrived{0};
+        std::atomic<bool> sense{false};
+        std::atomic<bool> aborted{false};
+        double slots[kMaxRanks][kSlotDoubles] = {};
+    };
+    
+    Segment* segment_ = nullptr;
+    int rank_;
+    bool local_sense_ = false;
+};
+#endif
+
+/**
+ * Header of the segment through which simulate_distributed hands a job to
+ * its rank processes: this struct, num_matches int64 matches, then one
+ * result block per rank (a sample count and (index, count) pairs)
+ */
+struct DistributedJob {
+    uint64_t n_qubits, iterations, shots, seed, num_matches, num_ranks;
+    
+    size_t result_block_bytes() const { return (1 + 2 * shots) * sizeof(uint64_t); }
+    size_t size_bytes() const { return sizeof(DistributedJob) + num_matches * sizeof(int64_t) + num_ranks * result_block_bytes(); }
+    int64_t* matches(void* segment) const {
+        return reinterpret_cast<int64_t*>(static_cast<char*>(segment) + sizeof(DistributedJob));
+    }
+    uint64_t* results(void* segment, int rank) const {
+        return reinterpret_cast<uint64_t*>(reinterpret_cast<char*>(matches(segment) + num_matches) + rank * result_block_bytes());
+    }
+};
+
+/**
+ * One rank's share of a Grover statevector partitioned across a communicator.
+ * Rank r owns basis states [r*N/size, (r+1)*N/size); the diffusion mean is an
+ * allreduce over the ranks' partial sums.
+ */
+class DistributedGroverSimulator {
+public:
+    DistributedGroverSimulator(Communicator& comm, int n_qubits, const std::vector<int>& marked)
+        : comm_(comm), n_qubits_(n_qubits) {
+        dimension_ = uint64_t(1) << n_qubits;
+        if (dimension_ < static_cast<uint64_t>(comm.size())) {
+            throw std::invalid_argument("more ranks than basis states");
+        }
+        begin_ = dimension_ * comm.rank() / comm.size();
+        end_ = dimension_ * (comm.rank() + 1) / comm.size();
+        for (int m : marked) {
+            if (m >= 0 && static_cast<uint64_t>(m) >= begin_ && static_cast<uint64_t>(m) < end_) {
+                local_marked_.push_back(static_cast<uint64_t>(m) - begin_);
+            }
+        }
+        amplitudes_ = PageBuffer<std::complex<double>>(end_ - begin_);
+        reset();
+    }
+    
+    void reset() {
+        const std::complex<double> uniform(1.0 / std::sqrt(static_cast<double>(dimension_)), 0.0);
+        std::fill(amplitudes_.data(), amplitudes_.data() + amplitudes_.size(), uniform);
+    }
+    
+    void iterate(int iterations) {
+        const size_t local = amplitudes_.size();
+        for (int k = 0; k < iterations; ++k) {
+            for (uint64_t m : local_marked_) amplitudes_[m] = -amplitudes_[m];
+            
+            std::complex<double> sum(0.0, 0.0);
+            for (size_t i = 0; i < local; ++i) sum += amplitudes_[i];
+            double partial[2] = {sum.real(), sum.imag()};
+            comm_.allreduce_sum(partial, 2);
+            
+            const std::complex<double> twice_mean =
+                2.0 * std::complex<double>(partial[0], partial[1]) / static_cast<double>(dimension_);
+            for (size_t i = 0; i < local; ++i) amplitudes_[i] = twice_mean - amplitudes_[i];
+        }
+    }
+    
+    /**
+     * Sample `shots` measurements collectively. Every rank draws the same
+     * multinomial split of shots across ranks from the shared seed, then
+     * samples its own share locally. Returns this rank's (index, count) pairs.
+     */
+    std::vector<std::pair<uint64_t, int>> sample(int shots, uint64_t seed) {
+        const int size = comm_.size();
+        const size_t local = amplitudes_.size();
+        
+        double local_mass = 0.0;
+        for (size_t i = 0; i < local; ++i) local_mass += std::norm(amplitudes_[i]);
+        std::vector<double> masses(size, 0.0);
+        masses[comm_.rank()] = local_mass;
+        comm_.allreduce_sum(masses.data(), size);
+        
+        std::mt19937_64 shared(seed);
+        std::discrete_distribution<int> pick_rank(masses.begin(), masses.end());
+        int my_shots = 0;
+        for (int s = 0; s < shots; ++s) {
+            if (pick_rank(shared) == comm_.rank()) ++my_shots;
+        }
+        
+        std::mt19937_64 rng(seed + 1 + comm_.rank());
+        return sample_amplitudes(amplitudes_.data(), local, begin_, local_mass, my_shots, rng);
+    }
+    
+private:
+    Communicator& comm_;
+    int n_qubits_;
+    uint64_t dimension_;
+    uint64_t begin_;
+    uint64_t end_;
+    std::vector<uint64_t> local_marked_;
+    PageBuffer<std::complex<double>> amplitudes_;
+};
+
+/**
+ * One gate of a compiled circuit. Qubit indices below the data width address
+ * the search register; the rest address the ancilla register.
+ */
+struct Gate {
+    std::string name;  // OpenQASM 3 stdgates name, or "gphase"
+    std::vector<int> qubits;
+    double angle = 0.0;
+};
+
+/**
+ * Gate-level Grover circuit: H layer, `iterations` x (oracle, diffusion), and
+ * measurement. Qubit q holds bit q of the basis index, so counts read the same
+ * as GroverSimulator and the Qiskit path.
+ *
+ * The oracle is either one multi-controlled Z per match ("mcz", X layers
+ * between consecutive matches only on the bits that change, matches visited
+ * in Gray-code order) or a Gray-code CNOT + Rz network from the Walsh-Hadamard
+ * spectrum of the diagonal ("gray", 2^n - 1 CNOTs independent of M); "auto"
+ * takes the cheaper one. Multi-controlled X uses a Toffoli V-chain over
+ * n - 3 clean ancillas.
+ */
+class GroverCircuit {
+public:
+    static constexpr int kMaxGrayQubits = 20;
+    
+    GroverCircuit(int n_qubits, const std::vector<int>& matches, int iterations,
+                  const std::string& oracle_method = "auto", bool measure = true)
+        : n_qubits_(n_qubits), iterations_(iterations), measure_(measure) {
+        if (n_qubits < 1 || n_qubits > 40) {
+            throw std::invalid_argument("n_qubits must be between 1 and 40");
+        }
+        if (iterations < 0) {
+            throw std::invalid_argument("iterations must be non-negative");
+        }
+        if (oracle_method != "auto" && oracle_method != "mcz" && oracle_method != "gray") {
+            throw std::invalid_argument("oracle_method must be 'auto', 'mcz' or 'gray'");
+        }
+        const uint64_t dimension = uint64_t(1) << n_qubits;
+        std::vector<uint64_t> marked;
+        for (int m : matches) {
+            if (m >= 0 && static_cast<uint64_t>(m) < dimension) marked.push_back(m);
+        }
+        std::sort(marked.begin(), marked.end());
+        marked.erase(std::unique(marked.begin(), marked.end()), marked.end());
+        
+        num_ancillas_ = std::max(0, n_qubits - 3);
+        
+        const double mcz_cost = static_cast<double>(marked.size()) * mcz_cnot_cost(n_qubits);
+        const double gray_cost = std::ldexp(1.0, n_qubits) - 1.0;
+        oracle_method_ = oracle_method;
+        if (oracle_method_ == "auto") {
+            oracle_method_ = n_qubits <= kMaxGrayQubits && gray_cost < mcz_cost ? "gray" : "mcz";
+        }
+        if (oracle_method_ == "gray" && n_qubits > kMaxGrayQubits) {
+            throw std::invalid_argument("gray oracle supports at most 20 qubits");
+        }
+        
+        oracle_ = cached_oracle(marked);
+        diffusion_ = cached_diffusion();
+    }
+    
+    int n_qubits() const { return n_qubits_; }
+    int num_ancillas() const { return num_ancillas_; }
+    int iterations() const { return iterations_; }
+    const std::string& oracle_method() const { return oracle_method_; }
+    const std::vector<Gate>& oracle() const { return *oracle_; }
+    const std::vector<Gate>& diffusion() const { return *diffusion_; }
+    
+    /**
+     * Template cache hits, misses and entries
+     */
+    static std::unordered_map<std::string, long long> cache_info() {
+        Cache& c = cache();
+        std::lock_guard<std::mutex> lock(c.mutex);
+        long long oracles = 0;
+        for (const auto& bucket : c.oracles) oracles += static_cast<long long>(bucket.second.size());
+        return {{"hits", c.hits}, {"misses", c.misses}, {"oracles", oracles},
+                {"diffusions", static_cast<long long>(c.diffusions.size())}};
+    }
+    
+    static void clear_cache() {
+        Cache& c = cache();
+        std::lock_guard<std::mutex> lock(c.mutex);
+        c.oracles.clear();
+        c.diffusions.clear();
+        c.hits = c.misses = 0;
+    }
+    
+    /**
+     * Gate counts of the unrolled circuit by gate name (measure included)
+     */
+    std::unordered_map<std::string, long long> gate_counts() const {
+        std::unordered_map<std::string, long long> counts;
+        counts["h"] += n_qubits_;
+        for (const Gate& g : *oracle_) counts[g.name] += iterations_;
+        for (const Gate& g : *diffusion_) counts[g.name] += iterations_;
+        if (measure_) counts["measure"] += n_qubits_;
+        for (auto it = counts.begin(); it != counts.end();) {
+            it = it->second == 0 ? counts.erase(it) : std::next(it);
+        }
+        return counts;
+    }
+    
+    /**
+     * Circuit depth by ASAP layering over data and ancilla qubits
+     * (global phases are free, measurement is one layer). Once one iteration
+     * advances every qubit by the same amount, the rest are extrapolated.
+     */
+    long long depth() const {
+        std::vector<long long> level(n_qubits_ + num_ancillas_, 0);
+        auto place = [&](const Gate& g) {
+            if (g.name == "gphase") return;
+            long long layer = 0;
+            for (int q : g.qubits) layer = std::max(layer, level[q]);
+            for (int q : g.qubits) level[q] = layer + 1;
+        };
+        for (int q = 0; q < n_qubits_; ++q) place({"h", {q}});
+        for (int k = 0; k < iterations_; ++k) {
+            const std::vector<long long> before = level;
+            for (const Gate& g : *oracle_) place(g);
+            for (const Gate& g : *diffusion_) place(g);
+            const long long step = level[0] - before[0];
+            bool uniform = true;
+            for (size_t q = 1; q < level.size() && uniform; ++q) uniform = level[q] - before[q] == step;
+            if (uniform) {
+                for (long long& l : level) l += step * (iterations_ - k - 1);
+                break;
+            }
+        }
+        long long depth = *std::max_element(level.begin(), level.end());
+        if (measure_) depth += 1;
+        return depth;
+    }
+    
+    /**
+     * OpenQASM 3 source. By default the oracle and diffusion are `gate`
+     * definitions applied in a `for` loop; `unrolled` writes every gate.
+     */
+    std::string to_qasm(bool unrolled = false) const {
+        std::ostringstream out;
+        out << std::setprecision(17);
+        out << "OPENQASM 3.0;\ninclude \"stdgates.inc\";\n";
+        out << "// Grover search: " << n_qubits_ << " qubits, " << iterations_ << " iterations, "
+            << oracle_method_ << " oracle\n";
+        if (!unrolled) {
+            write_definition(out, "grover_oracle", *oracle_);
+            write_definition(out, "grover_diffusion", *diffusion_);
+        }
+        out << "qubit[" << n_qubits_ << "] q;\n";
+        if (num_ancillas_ > 0) out << "qubit[" << num_ancillas_ << "] anc;\n";
+        if (measure_) out << "bit[" << n_qubits_ << "] c;\n";
+        for (int q = 0; q < n_qubits_; ++q) out << "h q[" << q << "];\n";
+        if (unrolled) {
+            for (int k = 0; k < iterations_; ++k) {
+                for (const Gate& g : *oracle_) write_gate(out, g);
+                for (const Gate& g : *diffusion_) write_gate(out, g);
+            }
+        } else if (iterations_ > 0) {
+            out << "for uint i in [0:" << iterations_ - 1 << "] {\n";
+            for (const char* name : {"grover_oracle", "grover_diffusion"}) {
+                out << "    " << name;
+                for (int q = 0; q < n_qubits_ + num_ancillas_; ++q) {
+                    out << (q == 0 ? " " : ", ") << qubit_name(q, false);
+                }
+                out << ";\n";
+            }
+            out << "}\n";
+        }
+        if (measure_) out << "c = measure q;\n";
+        return out.str();
+    }
+    
+private:
+    static double mcz_cnot_cost(int width) {
+        if (width <= 1) return 0.0;
+        if (width == 2) return 1.0;
+        return 6.0 * (2 * (width - 1) - 3);  // V-chain Toffolis at 6 CNOTs each
+    }
+    
+    using GateList = std::vector<Gate>;
+    
+    struct OracleEntry {
+        int n_qubits;
+        std::string method;
+        std::vector<uint64_t> marked;
+        std::shared_ptr<const GateList> gates;
+    };
+    
+    struct Cache {
+        static constexpr size_t kMaxOracles = 1024;
+        std::mutex mutex;
+        std::unordered_map<uint64_t, std::vector<OracleEntry>> oracles;  // By match-set hash
+        std::unordered_map<int, std::shared_ptr<const GateList>> diffusions;  // By n_qubits
+        size_t num_oracles = 0;
+        long long hits = 0;
+        long long misses = 0;
+    };
+    
+    static Cache& cache() {
+        static Cache instance;
+        return instance;
+    }
+    
+    uint64_t match_set_hash(const std::vector<uint64_t>& marked) const {
+        auto mix = [](uint64_t x) {  // splitmix64 finaliser
+            x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+            x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+            return x ^ (x >> 31);
+        };
+        uint64_t h = mix(static_cast<uint64_t>(n_qubits_) << 1 | (oracle_method_ == "gray"));
+        for (uint64_t m : marked) h = mix(h ^ m);
+        return h;
+    }
+    
+    std::shared_ptr<const GateList> cached_oracle(const std::vector<uint64_t>& marked) {
+        Cache& c = cache();
+        const uint64_t key = match_set_hash(marked);
+        {
+            std::lock_guard<std::mutex> lock(c.mutex);
+            auto it = c.oracles.find(key);
+            if (it != c.oracles.end()) {
+                for (const OracleEntry& e : it->second) {
+                    if (e.n_qubits == n_qubits_ && e.method == oracle_method_ && e.marked == marked) {
+                        ++c.hits;
+                        return e.gates;
+                    }
+                }
+            }
+            ++c.misses;
+        }
+        auto gates = std::make_shared<GateList>();
+        if (oracle_method_ == "gray") {
+            build_gray_oracle(*gates, marked);
+        } else {
+            build_mcz_oracle(*gates, marked);
+        }
+        std::lock_guard<std::mutex> lock(c.mutex);
+        if (c.num_oracles >= Cache::kMaxOracles) {
+            c.oracles.clear();
+            c.num_oracles = 0;
+        }
+        c.oracles[key].push_back({n_qubits_, oracle_method_, marked, gates});
+        ++c.num_oracles;
+        return gates;
+    }
+    
+    std::shared_ptr<const GateList> cached_diffusion() {
+        Cache& c = cache();
+        {
+            std::lock_guard<std::mutex> lock(c.mutex);
+            auto it = c.diffusions.find(n_qubits_);
+            if (it != c.diffusions.end()) {
+                ++c.hits;
+                return it->second;
+            }
+            ++c.misses;
+        }
+        auto gates = std::make_shared<GateList>();
+        build_diffusion(*gates);
+        std::lock_guard<std::mutex> lock(c.mutex);
+        return c.diffusions.emplace(n_qubits_, gates).first->second;
+    }
+    
+    /**
+     * Register element in the program body, or gate parameter inside a
+     * definition (d<i> for data qubits, a<i> for ancillas)
+     */
+    std::string qubit_name(int q, bool in_definition) const {
+        if (in_definition) return q < n_qubits_ ? "d" + std::to_string(q) : "a" + std::to_string(q - n_qubits_);
+        return q < n_qubits_ ? "q[" + std::to_string(q) + "]" : "anc[" + std::to_string(q - n_qubits_) + "]";
+    }
+    
+    void write_gate(std::ostringstream& out, const Gate& g, bool in_definition = false) const {
+        if (in_definition) out << "    ";
+        out << g.name;
+        if (g.name == "rz" || g.name == "gphase") out << "(" << g.angle << ")";
+        for (size_t i = 0; i < g.qubits.size(); ++i) {
+            out << (i == 0 ? " " : ", ") << qubit_name(g.qubits[i], in_definition);
+        }
+        out << ";\n";
+    }
+    
+    void write_definition(std::ostringstream& out, const char* name, const GateList& body) const {
+        out << "gate " << name;
+        for (int q = 0; q < n_qubits_ + num_ancillas_; ++q) {
+            out << (q == 0 ? " " : ", ") << qubit_name(q, true);
+        }
+        out << " {\n";
+        for (const Gate& g : body) write_gate(out, g, true);
+        out << "}\n";
+    }
+    
+    /**
+     * Multi-controlled X as a Toffoli V-chain through clean ancillas
+     */
+    void append_mcx(std::vector<Gate>& gates, const std::vector<int>& controls, int target) const {
+        const int k = static_cast<int>(controls.size());
+        if (k == 0) { gates.push_back({"x", {target}}); return; }
+        if (k == 1) { gates.push_back({"cx", {controls[0], target}}); return; }
+        if (k == 2) { gates.push_back({"ccx", {controls[0], controls[1], target}}); return; }
+        auto anc = [&](int i) { return n_qubits_ + i; };
+        std::vector<Gate> compute;
+        compute.push_back({"ccx", {controls[0], controls[1], anc(0)}});
+        for (int i = 2; i < k - 1; ++i) compute.push_back({"ccx", {controls[i], anc(i - 2), anc(i - 1)}});
+        gates.insert(gates.end(), compute.begin(), compute.end());
+        gates.push_back({"ccx", {controls[k - 1], anc(k - 3), target}});
+        gates.insert(gates.end(), compute.rbegin(), compute.rend());
+    }
+    
+    void append_mcz(std::vector<Gate>& gates) const {
+        if (n_qubits_ == 1) { gates.push_back({"z", {0}}); return; }
+        if (n_qubits_ == 2) { gates.push_back({"cz", {0, 1}}); return; }
+        const int target = n_qubits_ - 1;
+        std::vector<int> controls(target);
+        for (int q = 0; q < target; ++q) controls[q] = q;
+        gates.push_back({"h", {target}});
+        append_mcx(gates, controls, target);
+        gates.push_back({"h", {target}});
+    }
+    
+    void append_x_mask(std::vector<Gate>& gates, uint64_t mask) const {
+        for (int q = 0; q < n_qubits_; ++q) {
+            if (mask >> q & 1) gates.push_back({"x", {q}});
+        }
+    }
+    
+    void build_mcz_oracle(GateList& oracle, std::vector<uint64_t> marked) const {
+        // Gray-code order keeps consecutive matches a few bit flips apart
+        auto gray_rank = [](uint64_t g) {
+            for (uint64_t shift = g >> 1; shift; shift >>= 1) g ^= shift;
+            return g;
+        };
+        std::sort(marked.begin(), marked.end(),
+                  [&](uint64_t a, uint64_t b) { return gray_rank(a) < gray_rank(b); });
+        const uint64_t all = (uint64_t(1) << n_qubits_) - 1;
+        uint64_t flipped = 0;
+        for (uint64_t m : marked) {
+            const uint64_t want = ~m & all;  // X on the zero bits turns |m> into |1...1>
+            append_x_mask(oracle, flipped ^ want);
+            append_mcz(oracle);
+            flipped = want;
+        }
+        append_x_mask(oracle, flipped);
+    }
+    
+    /**
+     * exp(i pi f(x)) = prod_S exp(i a_S chi_S(x)) with a_S = (pi/N) WHT(f)[S].
+     * Each parity chi_S is accumulated on its top qubit by walking the lower
+     * bits in Gray-code order, one CNOT per step, with Rz(-2 a_S) applied at
+     * each stop; the empty set is the global phase.
+     */
+    void build_gray_oracle(GateList& oracle, const std::vector<uint64_t>& marked) const {
+        const uint64_t dimension = uint64_t(1) << n_qubits_;
+        std::vector<double> spectrum(dimension, 0.0);
+        for (uint64_t m : marked) spectrum[m] = 1.0;
+        for (uint64_t len = 1; len < dimension; len <<= 1) {
+            for (uint64_t i = 0; i < dimension; i += len << 1) {
+                for (uint64_t j = i; j < i + len; ++j) {
+                    const double a = spectrum[j], b = spectrum[j + len];
+                    spectrum[j] = a + b;
+                    spectrum[j + len] = a - b;
+                }
+            }
+        }
+        const double scale = M_PI / static_cast<double>(dimension);
+        auto rotate = [&](uint64_t subset, int target) {
+            const double a = scale * spectrum[subset];
+            if (std::fabs(a) > 1e-12) oracle.push_back({"rz", {target}, -2.0 * a});
+        };
+        
+        // Adjacent identical CNOTs (a skipped zero rotation between them) cancel
+        auto cnot = [&](int control, int target) {
+            if (!oracle.empty() && oracle.back().name == "cx" &&
+                oracle.back().qubits == std::vector<int>{control, target}) {
+                oracle.pop_back();
+            } else {
+                oracle.push_back({"cx", {control, target}});
+            }
+        };
+        
+        if (std::fabs(scale * spectrum[0]) > 1e-12) oracle.push_back({"gphase", {}, scale * spectrum[0]});
+        for (int top = 0; top < n_qubits_; ++top) {
+            const uint64_t top_bit = uint64_t(1) << top;
+            rotate(top_bit, top);
+            uint64_t previous = 0;
+            for (uint64_t i = 1; i < top_bit; ++i) {
+                const uint64_t gray = i ^ (i >> 1);
+                const int changed = bits::ctz64(gray ^ previous);
+                cnot(changed, top);
+                previous = gray;
+                rotate(gray | top_bit, top);
+            }
+            if (previous) cnot(bits::ctz64(previous), top);
+        }
+    }
+    
+    /**
+     * H X (multi-controlled Z) X H: the reflection 2|s><s| - I up to sign
+     */
+    void build_diffusion(GateList& diffusion) const {
+        const uint64_t all = (uint64_t(1) << n_qubits_) - 1;
+        for (int q = 0; q < n_qubits_; ++q) diffusion.push_back({"h", {q}});
+        append_x_mask(diffusion, all);
+        append_mcz(diffusion);
+        append_x_mask(diffusion, all);
+        for (int q = 0; q < n_qubits_; ++q) diffusion.push_back({"h", {q}});
+    }
+    
+    int n_qubits_;
+    int iterations_;
+    bool measure_;
+    int num_ancillas_ = 0;
+    std::string oracle_method_;
+    std::shared_ptr<const std::vector<Gate>> oracle_;
+    std::shared_ptr<const std::vector<Gate>> diffusion_;
+};
+
+class GroverAccelerator {
+public:
+    /**
+     * Fast DNA sequence encoding - converts positions to binary representations
+     */
+    std::vector<std::string> encode_positions(int num_candidates, int n_qubits) {
+        std::vector<std::string> encodings;
+        encodings.reserve(num_candidates);
+        
+        for (int pos = 0; pos < num_candidates; ++pos) {
+            std::string binary;
+            binary.reserve(n_qubits);
+            
+            // Convert to binary with zero padding
+            for (int bit = n_qubits - 1; bit >= 0; --bit) {
+                binary += ((pos >> bit) & 1) ? '1' : '0';
+            }
+            encodings.push_back(binary);
+        }
+        
+        return encodings;
+    }
+    
+    /**
+     * High-performance pattern matching using optimized string search.
+     * Occurrences overlapping a masked base are skipped.
+     */
+    std::vector<int> find_pattern_matches(const std::string& sequence, const std::string& pattern,
+                                          const SequenceMask* mask = nullptr) {
+        std::vector<int> matches;
+        
+        if (pattern.empty() || sequence.empty() || pattern.length() > sequence.length()) {
+            return matches;
+        }
+        check_mask(mask, sequence.length());
+        
+        // Reserve space to avoid reallocations
+        matches.reserve(sequence.length() / 10); // Rough estimate
+        
+        // Boyer-Moore-inspired optimization for DNA sequences
+        scan_unmasked(mask, pattern.length(), 0, sequence.length() - pattern.length() + 1,
+                      [&](size_t begin, size_t end) { scan_range(sequence.data(), pattern, begin, end, matches); });
+        
+        return matches;
+    }
+    
+    /**
+     * Pattern matching with IUPAC ambiguity codes (either case). A position
+     * matches when every sequence symbol's base set lies within the pattern
+     * symbol's set, so pattern 'R' matches A or G, while an 'N' in the
+     * sequence only matches an 'N' in the pattern.
+     */
+    std::vector<int> find_pattern_matches_iupac(const std::string& sequence, const std::string& pattern,
+                                                const SequenceMask* mask = nullptr) {
+        std::vector<int> matches;
+        if (pattern.empty() || sequence.empty() || pattern.length() > sequence.length()) {
+            return matches;
+        }
+        check_mask(mask, sequence.length());
+        
+        const size_t pattern_len = pattern.length();
+        std::vector<uint8_t> allowed(pattern_len);
+        for (size_t j = 0; j < pattern_len; ++j) {
+            allowed[j] = alphabet::iupac(pattern[j]);
+            if (!allowed[j]) throw std::invalid_argument("pattern contains a non-IUPAC symbol");
+        }
+        
+        const size_t search_len = sequence.length() - pattern_len + 1;
+        scan_unmasked(mask, pattern_len, 0, search_len, [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i) {
+                bool match = true;
+                for (size_t j = 0; j < pattern_len && match; ++j) {
+                    const uint8_t bases = alphabet::iupac(sequence[i + j]);
+                    match = bases && !(bases & ~allowed[j]);
+                }
+                if (match) matches.push_back(static_cast<int>(i));
+            }
+        });
+        return matches;
+    }
+    
+    /**
+     * Pattern matching over every record of a corpus; matches never span a
+     * record junction. A mask, if given, covers the whole corpus.
+     *
+     * Window starts are cut into tasks of about equal size: large records are
+     * split into chunks and runs of small records are grouped, and the tasks
+     * run on a work-stealing pool. Tasks follow (record, offset) order, so
+     * their results are concatenated without sorting. num_threads <= 0 uses
+     * the tuned thread count; the minimum task size is always tuned.
+     */
+    CorpusHits find_pattern_matches_corpus(const SequenceCorpus& corpus, const std::string& pattern,
+                                           int num_threads = 0, const SequenceMask* mask = nullptr) {
+        const tuning::Profile profile = tuned();
+        if (num_threads <= 0) {
+            num_threads = profile.scan_threads;
+        }
+        return search_corpus(corpus, pattern, mask, num_threads, profile.corpus_task_windows,
+                             num_threads > 1 ? pool(num_threads).get() : nullptr);
+    }
+    
+    /**
+     * Pattern matching that picks serial or parallel scanning, and the thread
+     * count, from the tuning profile (calibrated on first use)
+     */
+    std::vector<int> find_pattern_matches_auto(const std::string& sequence, const std::string& pattern,
+                                               const SequenceMask* mask = nullptr) {
+        const int threads = tuned_threads(sequence.length());
+        if (threads == 1) {
+            return find_pattern_matches(sequence, pattern, mask);
+        }
+        return find_pattern_matches_parallel(sequence, pattern, threads, false, mask);
+    }
+    
+    /**
+     * Threads find_pattern_matches_auto uses for a sequence of this length
+     */
+    static int tuned_threads(uint64_t sequence_length) {
+        const tuning::Profile profile = tuned();
+        if (profile.scan_threads <= 1 || sequence_length < profile.scan_parallel_threshold) {
+            return 1;
+        }
+        const uint64_t threads = sequence_length / std::max<uint64_t>(1, profile.scan_min_chunk);
+        return static_cast<int>(std::clamp<uint64_t>(threads, 2, profile.scan_threads));
+    }
+    
+    /**
+     * The tuning profile: loaded from the profile file, or calibrated and
+     * saved when the file is missing, stale or recalibrate is set
+     */
+    static tuning::Profile tuned(bool recalibrate = false) {
+        std::lock_guard<std::mutex> lock(tuning::profile_mutex);
+        std::unique_ptr<tuning::Profile>& cached = tuning::cached();
+        if (!cached || recalibrate) {
+            auto profile = std::make_unique<tuning::Profile>();
+            const std::string path = tuning::profile_path();
+            if (recalibrate || !tuning::load(path, *profile)) {
+                *profile = calibrate();
+                tuning::save(path, *profile);
+            }
+            cached = std::move(profile);
+        }
+        return *cached;
+    }
+    
+    /**
+     * Corpus search with explicit task sizing; runs serially without a pool.
+     * Keeps only the first max_hits hits (each task stores at most that many
+     * and counts the rest); the count of all matches goes to total when given.
+     */
+    static CorpusHits search_corpus(const SequenceCorpus& corpus, const std::string& pattern,
+                                    const SequenceMask* mask, int num_threads, uint64_t min_task,
+                                    WorkStealingPool* workers, size_t max_hits = SIZE_MAX,
+                                    uint64_t* total = nullptr) {
+        CorpusHits hits;
+        if (total) *total = 0;
+        if (pattern.empty()) {
+            return hits;
+        }
+        check_mask(mask, corpus.total_length());
+        num_threads = std::max(1, num_threads);
+        
+        const size_t pattern_len = pattern.length();
+        const uint64_t* starts = corpus.starts();
+        uint64_t total_windows = 0;
+        for (size_t r = 0; r < corpus.num_records(); ++r) {
+            total_windows += windows_in(starts[r + 1] - starts[r], pattern_len);
+        }
+        
+        // Segments of global window starts; task t owns segments [task_starts[t], task_starts[t + 1])
+        struct Segment { uint32_t record; uint64_t begin, end; };
+        std::vector<Segment> segments;
+        std::vector<size_t> task_starts{0};
+        const uint64_t grain = std::max<uint64_t>(std::max<uint64_t>(1, min_task),
+                                                  total_windows / (num_threads * kCorpusTasksPerThread));
+        uint64_t task_windows = 0;
+        for (uint32_t r = 0; r < corpus.num_records(); ++r) {
+            const uint64_t end = starts[r] + windows_in(starts[r + 1] - starts[r], pattern_len);
+            for (uint64_t begin = starts[r]; begin < end;) {
+                const uint64_t stop = std::min(end, begin + (grain - task_windows));
+                segments.push_back({r, begin, stop});
+                task_windows += stop - begin;
+                begin = stop;
+                if (task_windows == grain) {
+                    task_starts.push_back(segments.size());
+                    task_windows = 0;
+                }
+            }
+        }
+        if (segments.size() > task_starts.back()) task_starts.push_back(segments.size());
+        
+        const size_t num_tasks = task_starts.size() - 1;
+        std::vector<CorpusHits> results(num_tasks);
+        std::vector<uint64_t> found(num_tasks, 0);
+        std::function<void(size_t)> run_task = [&](size_t t) {
+            CorpusHits& local = results[t];
+            for (size_t s = task_starts[t]; s < task_starts[t + 1]; ++s) {
+                const Segment& segment = segments[s];
+                const size_t first = local.offsets.size();
+                scan_unmasked(mask, pattern_len, segment.begin, segment.end, [&](size_t a, size_t b) {
+                    found[t] += scan_range(corpus.data(), pattern, a, b, local.offsets, max_hits);
+                });
+                for (size_t i = first; i < local.offsets.size(); ++i) local.offsets[i] -= starts[segment.record];
+                local.record_ids.resize(local.offsets.size(), segment.record);
+            }
+        };
+        if (!workers || num_tasks <= 1) {
+            for (size_t t = 0; t < num_tasks; ++t) run_task(t);
+        } else {
+            workers->run(num_tasks, run_task);
+        }
+        
+        size_t total_hits = 0;
+        for (size_t t = 0; t < num_tasks; ++t) {
+            total_hits += results[t].offsets.size();
+            if (total) *total += found[t];
+        }
+        total_hits = std::min(total_hits, max_hits);
+        hits.record_ids.reserve(total_hits);
+        hits.offsets.reserve(total_hits);
+        for (const auto& local : results) {
+            const size_t take = std::min(local.offsets.size(), total_hits - hits.offsets.size());
+            hits.record_ids.insert(hits.record_ids.end(), local.record_ids.begin(), local.record_ids.begin() + take);
+            hits.offsets.insert(hits.offsets.end(), local.offsets.begin(), local.offsets.begin() + take);
+        }
+        return hits;
+    }
+    
+    /**
+     * Corpus matches as a MatchTable, including reverse-strand matches (hits
+     * of the pattern's reverse complement) unless both_strands is false.
+     * Reverse-strand hits are in forward coordinates, so one mask covers both.
+     */
+    MatchTable find_matches_table(const SequenceCorpus& corpus, const std::string& pattern, bool both_strands = true,
+                                  int num_threads = 0, const SequenceMask* mask = nullptr) {
+        CorpusHits forward = find_pattern_matches_corpus(corpus, pattern, num_threads, mask);
+        if (!both_strands) {
+            return MatchTable::from_hits(std::move(forward), 1);
+        }
+        std::string rc(pattern.size(), '\0');
+        seqops::reverse_complement(pattern.data(), pattern.size(), &rc[0]);
+        return MatchTable::from_strands(forward, find_pattern_matches_corpus(corpus, rc, num_threads, mask));
+    }
+    
+    /**
+     * Every pattern's matches from one Aho-Corasick pass over the corpus;
+     * result p holds pattern p's hits in (record, offset) order
+     */
+    std::vector<CorpusHits> find_pattern_matches_multi(const SequenceCorpus& corpus,
+                                                       const std::vector<std::string>& patterns,
+                                                       int num_threads = 0, const SequenceMask* mask = nullptr) {
+        const tuning::Profile profile = tuned();
+        if (num_threads <= 0) {
+            num_threads = profile.scan_threads;
+        }
+        return search_corpus_multi(corpus, AhoCorasick(patterns), num_threads, profile.corpus_task_windows,
+                                   num_threads > 1 ? pool(num_threads).get() : nullptr, nullptr, nullptr, mask);
+    }
+    
+    /**
+     * Multi-pattern corpus search with explicit task sizing; each task scans
+     * a slice of one record plus the overlap a match starting in it can need.
+     * With max_hits, pattern p keeps only its first max_hits[p] hits and its
+     * count of all matches goes to (*totals)[p] when totals is given. With a
+     * mask, only the unmasked runs are fed to the automaton.
+     */
+    static std::vector<CorpusHits> search_corpus_multi(const SequenceCorpus& corpus, const AhoCorasick& matcher,
+                                                       int num_threads, uint64_t min_task, WorkStealingPool* workers,
+                                                       const std::vector<size_t>* max_hits = nullptr,
+                                                       std::vector<uint64_t>* totals = nullptr,
+                                                       const SequenceMask* mask = nullptr) {
+        check_mask(mask, corpus.total_length());
+        const size_t P = matcher.num_patterns();
+        auto cap = [&](size_t p) { return max_hits ? (*max_hits)[p] : SIZE_MAX; };
+        size_t overlap = 0;
+        for (size_t p = 0; p < P; ++p) overlap = std::max(overlap, matcher.pattern_length(p) - 1);
+        
+        struct Slice { uint32_t record; uint64_t begin, end; };
+        std::vector<Slice> slices;
+        const uint64_t* starts = corpus.starts();
+        const uint64_t grain = std::max<uint64_t>(std::max<uint64_t>(1, min_task),
+                                                  corpus.total_length() / (std::max(1, num_threads) * kCorpusTasksPerThread));
+        for (uint32_t r = 0; r < corpus.num_records(); ++r) {
+            for (uint64_t begin = starts[r]; begin < starts[r + 1]; begin += grain) {
+                slices.push_back({r, begin, std::min(starts[r + 1], begin + grain)});
+            }
+        }
+        
+        std::vector<std::vector<CorpusHits>> results(slices.size(), std::vector<CorpusHits>(P));
+        std::vector<std::vector<uint64_t>> found(slices.size(), std::vector<uint64_t>(P, 0));
+        std::function<void(size_t)> run_task = [&](size_t t) {
+            const Slice& slice = slices[t];
+            const uint64_t limit = std::min<uint64_t>(starts[slice.record + 1], slice.end + overlap);
+            std::vector<CorpusHits>& local = results[t];
+            auto on_match = [&](uint32_t p, uint64_t start) {
+                ++found[t][p];
+                if (local[p].offsets.size() < cap(p)) local[p].offsets.push_back(start - starts[slice.record]);
+            };
+            if (!mask) {
+                matcher.scan(corpus.data(), slice.begin, slice.end, limit, on_match);
+            } else {
+                // A match read within one clear run touches no masked base
+                mask->for_each_clear_run(slice.begin, limit, [&](size_t a, size_t b) {
+                    if (a < slice.end) matcher.scan(corpus.data(), a, std::min<uint64_t>(b, slice.end), b, on_match);
+                });
+            }
+            for (auto& hits : local) hits.record_ids.resize(hits.offsets.size(), slice.record);
+        };
+        if (!workers || slices.size() <= 1) {
+            for (size_t t = 0; t < slices.size(); ++t) run_task(t);
+        } else {
+            workers->run(slices.size(), run_task);
+        }
+        
+        // One pattern's starts ascend within a slice and slices are in order
+        std::vector<CorpusHits> hits(P);
+        if (totals) totals->assign(P, 0);
+        for (size_t p = 0; p < P; ++p) {
+            for (size_t t = 0; t < slices.size(); ++t) {
+                const CorpusHits& local = results[t][p];
+                const size_t take = std::min(local.offsets.size(), cap(p) - hits[p].offsets.size());
+                hits[p].record_ids.insert(hits[p].record_ids.end(), local.record_ids.begin(), local.record_ids.begin() + take);
+                hits[p].offsets.insert(hits[p].offsets.end(), local.offsets.begin(), local.offsets.begin() + take);
+                if (totals) (*totals)[p] += found[t][p];
+            }
+        }
+        return hits;
+    }
+    
+    /**
+     * k-mer spectrum of the sequence (canonical k-mers by default)
+     */
+    KmerSpectrum count_kmers(const std::string& sequence, int k, bool canonical = true, int num_threads = 4) {
+        return KmerSpectrum::count(sequence.data(), sequence.size(), k, canonical, num_threads);
+    }
+    
+    /**
+     * Number of positions where pattern occurs (ground truth for M)
+     */
+    long long count_pattern_matches(const std::string& sequence, const std::string& pattern,
+                                    const SequenceMask* mask = nullptr) {
+        if (pattern.empty() || sequence.empty() || pattern.length() > sequence.length()) {
+            return 0;
+        }
+        check_mask(mask, sequence.length());
+        
+        const size_t pattern_len = pattern.length();
+        const size_t search_len = sequence.length() - pattern_len + 1;
+        long long count = 0;
+        scan_unmasked(mask, pattern_len, 0, search_len, [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i) {
+                count += sequence.compare(i, pattern_len, pattern) == 0;
+            }
+        });
+        return count;
+    }
+    
+    /**
+     * Parallel pattern matching for large sequences
+     */
+    std::vector<int> find_pattern_matches_parallel(const std::string& sequence, const std::string& pattern,
+                                                   int num_threads = 4, bool pin_threads = false,
+                                                   const SequenceMask* mask = nullptr) {
+        if (pattern.empty() || sequence.empty() || pattern.length() > sequence.length()) {
+            return std::vector<int>();
+        }
+        check_mask(mask, sequence.length());
+        
+        num_threads = std::max(1, num_threads);
+        const size_t sequence_len = sequence.length();
+        const size_t pattern_len = pattern.length();
+        const size_t search_len = sequence_len - pattern_len + 1;
+        const size_t chunk_size = search_len / num_threads;
+        
+        std::vector<size_t> bounds(num_threads + 1, search_len);
+        for (int t = 0; t < num_threads; ++t) {
+            bounds[t] = t * chunk_size;
+        }
+        
+        return scan_chunks(sequence.data(), pattern, bounds, mask, [&](int t) {
+            if (pin_threads) {
+                numa::pin_current_thread(numa::cpu_for_worker(t, num_threads));
+            }
+        });
+    }
+    
+    /**
+     * Parallel pattern matching over a NUMA-placed sequence. Each worker is
+     * pinned to the node holding its chunk, so scans read node-local memory.
+     */
+    std::vector<int> find_pattern_matches_placed(const PlacedSequence& sequence, const std::string& pattern,
+                                                 const SequenceMask* mask = nullptr) {
+        if (pattern.empty() || sequence.length() == 0 || pattern.length() > sequence.length()) {
+            return std::vector<int>();
+        }
+        check_mask(mask, sequence.length());
+        
+        const int num_threads = sequence.num_threads();
+        const size_t search_len = sequence.length() - pattern.length() + 1;
+        
+        std::vector<size_t> bounds(num_threads + 1);
+        for (int t = 0; t <= num_threads; ++t) {
+            if (sequence.policy() == "partition") {
+                // Scan exactly the chunk this worker's node first-touched
+                bounds[t] = std::min(search_len, sequence.bounds(t));
+            } else {
+                bounds[t] = search_len * t / num_threads;
+            }
+        }
+        
+        return scan_chunks(sequence.data(), pattern, bounds, mask, [&](int t) {
+            numa::pin_current_thread(numa::cpu_for_worker(t, num_threads));
+        });
+    }
+    
+    /**
+     * Fast diagonal matrix construction for oracle, in a PageBuffer like the
+     * statevector it multiplies. With a mask, a match whose pattern_length
+     * window touches a masked base stays unmarked.
+     */
+    PageBuffer<std::complex<double>> build_oracle_diagonal(const std::vector<int>& matches, int database_size,
+                                                           const SequenceMask* mask = nullptr,
+                                                           int pattern_length = 1) {
+        if (database_size < 0) throw std::invalid_argument("database_size must be non-negative");
+        PageBuffer<std::complex<double>> diagonal(database_size);
+        std::fill(diagonal.data(), diagonal.data() + diagonal.size(), std::complex<double>(1.0, 0.0));
+        
+        // Mark matching positions with -1 phase
+        for (int match : matches) {
+            if (mask && match >= 0 && mask->any(match, std::max(1, pattern_length))) {
+                continue;
+            }
+            if (match >= 0 && match < database_size) {
+                diagonal[match] = std::complex<double>(-1.0, 0.0);
+            }
+        }
+        
+        return diagonal;
+    }
+    
+    /**
+     * Calculate optimal number of Grover iterations
+     */
+    int calculate_optimal_iterations(int total_items, int marked_items) {
+        if (marked_items <= 0 || total_items <= 0) {
+            return 1;
+        }
+        
+        double ratio = static_cast<double>(total_items) / static_cast<double>(marked_items);
+        int iterations = static_cast<int>(std::floor((M_PI / 4.0) * std::sqrt(ratio)));
+        
+        return std::max(1, iterations);
+    }
+    
+    /**
+     * Quantum counting: simulated phase estimation of the Grover operator G
+     * with `precision_qubits` counting qubits, evaluated analytically in the
+     * 2D subspace spanned by the marked and unmarked superpositions. G has
+     * eigenphases +-2*theta with sin^2(theta) = M/N and |s> has equal weight
+     * on both eigenvectors, so the outcome y follows a closed-form
+     * distribution and M_hat = N sin^2(pi y / 2^t).
+     *
+     * The interval is the Brassard-Hoyer-Mosca-Tapp bound
+     * |M_hat - M| <= 2 pi sqrt(M_hat (N - M_hat)) / 2^t + pi^2 N / 4^t,
+     * which holds with probability at least 8 / pi^2.
+     */
+    std::unordered_map<std::string, double> quantum_count(int n_qubits, const std::vector<int>& matches,
+                                                          int precision_qubits, uint64_t seed = 42) {
+        if (precision_qubits < 1 || precision_qubits > 24) {
+            throw std::invalid_argument("precision_qubits must be between 1 and 24");
+        }
+        GroverSimulator sim(n_qubits, matches);
+        const double N = static_cast<double>(sim.dimension());
+        const double M = static_cast<double>(sim.marked().size());
+        
+        const std::vector<double> outcome = phase_estimation_distribution(N, M, precision_qubits);
+        std::mt19937_64 rng(seed);
+        const size_t y = std::discrete_distribution<size_t>(outcome.begin(), outcome.end())(rng);
+        
+        const double estimate = counting_estimate(N, y, precision_qubits);
+        const double error_bound = counting_error_bound(N, estimate, precision_qubits);
+        
+        std::unordered_map<std::string, double> report;
+        report["estimate"] = estimate;
+        report["lower"] = std::max(0.0, estimate - error_bound);
+        report["upper"] = std::min(N, estimate + error_bound);
+        report["confidence"] = 8.0 / (M_PI * M_PI);
+        report["true_count"] = M;
+        report["abs_error"] = std::fabs(estimate - M);
+        report["precision_qubits"] = precision_qubits;
+        report["oracle_calls"] = std::ldexp(1.0, precision_qubits) - 1.0;
+        return report;
+    }
+    
+    /**
+     * Accuracy of quantum counting versus precision-qubit count, computed
+     * exactly from the outcome distribution for t = 1..max_precision_qubits:
+     * median absolute error, probability the bound interval covers the true
+     * M, and the most likely estimate.
+     */
+    std::vector<std::unordered_map<std::string, double>> quantum_count_sweep(int n_qubits,
+                                                                             const std::vector<int>& matches,
+                                                                             int max_precision_qubits) {
+        if (max_precision_qubits < 1 || max_precision_qubits > 24) {
+            throw std::invalid_argument("max_precision_qubits must be between 1 and 24");
+        }
+        GroverSimulator sim(n_qubits, matches);
+        const double N = static_cast<double>(sim.dimension());
+        const double M = static_cast<double>(sim.marked().size());
+        
+        std::vector<std::unordered_map<std::string, double>> rows;
+        for (int t = 1; t <= max_precision_qubits; ++t) {
+            const std::vector<double> outcome = phase_estimation_distribution(N, M, t);
+            // The Fejer tails make the mean error log-divergent in 2^t, so
+            // the median is the representative figure
+            std::vector<std::pair<double, double>> errors;  // (|M_hat - M|, p)
+            double coverage = 0.0, best_p = -1.0, most_likely = 0.0;
+            for (size_t y = 0; y < outcome.size(); ++y) {
+                const double estimate = counting_estimate(N, y, t);
+                errors.emplace_back(std::fabs(estimate - M), outcome[y]);
+                if (std::fabs(estimate - M) <= counting_error_bound(N, estimate, t)) coverage += outcome[y];
+                if (outcome[y] > best_p) {
+                    best_p = outcome[y];
+                    most_likely = estimate;
+                }
+            }
+            std::sort(errors.begin(), errors.end());
+            double median_error = 0.0, cumulative = 0.0;
+            for (const auto& e : errors) {
+                median_error = e.first;
+                if ((cumulative += e.second) >= 0.5) break;
+            }
+            std::unordered_map<std::string, double> row;
+            row["precision_qubits"] = t;
+            row["median_abs_error"] = median_error;
+            row["coverage"] = coverage;
+            row["most_likely_estimate"] = most_likely;
+            row["true_count"] = M;
+            row["oracle_calls"] = std::ldexp(1.0, t) - 1.0;
+            rows.push_back(row);
+        }
+        return rows;
+    }
+    
+    /**
+     * Find a marked state without knowing how many there are, using the
+     * Boyer-Brassard-Hoyer-Tapp randomized exponential schedule: each round
+     * runs j ~ U{0..ceil(m)-1} Grover iterations, measures, and checks the
+     * result classically; m then grows by 6/5 up to sqrt(N).
+     *
+     * Oracle calls count one per Grover iteration plus one per classical
+     * check. The report includes the exact expected number of calls for the
+     * true M (from the schedule's success probabilities) and the known-M
+     * optimum, so query complexity can be benchmarked.
+     */
+    std::unordered_map<std::string, double> search_unknown_count(int n_qubits, const std::vector<int>& matches,
+                                                                 uint64_t seed = 42,
+                                                                 long long max_oracle_calls = 0,
+                                                                 const std::string& strategy = "bbht",
+                                                                 int precision_qubits = 0) {
+        if (strategy != "bbht" && strategy != "counting") {
+            throw std::invalid_argument("strategy must be 'bbht' or 'counting'");
+        }
+        GroverSimulator sim(n_qubits, matches);
+        const double N = static_cast<double>(sim.dimension());
+        const double M = static_cast<double>(sim.marked().size());
+        const double lambda = 6.0 / 5.0;
+        const double m_cap = std::sqrt(N);
+        if (max_oracle_calls <= 0) {
+            max_oracle_calls = static_cast<long long>(std::ceil(10.0 * std::sqrt(N))) + 1;
+        }
+        
+        std::mt19937_64 rng(seed);
+        std::unordered_map<std::string, double> report;
+        long long oracle_calls = 0, grover_iterations = 0, rounds = 0;
+        bool found = false;
+        double position = -1.0;
+        double m = 1.0;
+        
+        // Counting strategy: estimate M by phase estimation first (2^t - 1
+        // controlled Grover operators), then repeat the iteration count that
+        // estimate implies
+        long long counted_iterations = -1;
+        if (strategy == "counting") {
+            if (precision_qubits <= 0) precision_qubits = (n_qubits + 1) / 2 + 3;
+            auto estimate = quantum_count(n_qubits, matches, precision_qubits, rng());
+            oracle_calls += static_cast<long long>(estimate["oracle_calls"]);
+            max_oracle_calls += oracle_calls;  // Search budget comes on top of the estimate
+            report["estimated_marked"] = estimate["estimate"];
+            const int m_hat = static_cast<int>(std::llround(estimate["estimate"]));
+            counted_iterations = m_hat > 0 ? calculate_optimal_iterations(static_cast<int>(std::min(N, 2147483647.0)), m_hat) : 0;
+            if (m_hat == 0) max_oracle_calls = oracle_calls;  // Estimated empty: stop
+        }
+        
+        while (!found && oracle_calls < max_oracle_calls) {
+            const long long choices = static_cast<long long>(std::ceil(m));
+            const long long j = counted_iterations >= 0 ? counted_iterations
+                                                        : std::uniform_int_distribution<long long>(0, choices - 1)(rng);
+            sim.reset();
+            sim.iterate(static_cast<int>(j));
+            const auto outcome = sim.sample(1, rng());
+            const uint64_t index = std::stoull(outcome.begin()->first, nullptr, 2);
+            
+            ++rounds;
+            grover_iterations += j;
+            oracle_calls += j + 1;
+            if (std::binary_search(sim.marked().begin(), sim.marked().end(), static_cast<int>(index))) {
+                found = true;
+                position = static_cast<double>(index);
+            }
+            m = std::min(lambda * m, m_cap);
+        }
+        
+        // Exact expected calls for the true M: sum over rounds of
+        // P(reach round) * E[j + 1], with P(success | j) = sin^2((2j+1)theta)
+        double expected_calls = 0.0;
+        if (M > 0) {
+            const double theta = std::asin(std::sqrt(M / N));
+            double reach = 1.0;
+            double mm = 1.0;
+            for (int r = 0; r < 100000 && reach > 1e-12; ++r) {
+                const long long choices = static_cast<long long>(std::ceil(mm));
+                double p_success = 0.0;
+                for (long long jj = 0; jj < choices; ++jj) {
+                    p_success += std::pow(std::sin((2 * jj + 1) * theta), 2);
+                }
+                p_success /= choices;
+                expected_calls += reach * (static_cast<double>(choices - 1) / 2.0 + 1.0);
+                reach *= 1.0 - p_success;
+                mm = std::min(lambda * mm, m_cap);
+            }
+        }
+        
+        if (strategy == "counting") expected_calls = 0.0;  // Schedule analysis applies to BBHT only
+        
+        report["found"] = found ? 1.0 : 0.0;
+        report["position"] = position;
+        report["oracle_calls"] = static_cast<double>(oracle_calls);
+        report["grover_iterations"] = static_cast<double>(grover_iterations);
+        report["rounds"] = static_cast<double>(rounds);
+        report["expected_oracle_calls"] = M > 0 || strategy == "counting" ? expected_calls
+                                                                           : static_cast<double>(max_oracle_calls);
+        report["known_m_oracle_calls"] = M > 0 ? calculate_optimal_iterations(static_cast<int>(std::min(N, 2147483647.0)),
+                                                                              static_cast<int>(M)) + 1.0 : 0.0;
+        report["num_marked"] = M;
+        return report;
+    }
+    
+    /**
+     * Grover simulation with the statevector partitioned across `num_ranks`
+     * local worker processes that communicate through POSIX shared memory.
+     * Returns measurement counts in the same format as GroverSimulator::run.
+     *
+     * Ranks are separate programs started with posix_spawn, never fork():
+     * the host process is multithreaded (thread pools, executors, servers),
+     * and a forked child of it may not allocate. Rank r runs
+     * rank_command + {segment name, r}, which must call
+     * run_distributed_rank(segment name, r); the Python binding passes the
+     * interpreter with a one-line entry point.
+     */
+    std::unordered_map<std::string, int> simulate_distributed(int n_qubits, const std::vector<int>& matches,
+                                                              int iterations, int num_ranks, int shots, uint64_t seed,
+                                                              const std::vector<std::string>& rank_command) {
+#if defined(__unix__) || defined(__APPLE__)
+        if (n_qubits < 1 || n_qubits > 40) {
+            throw std::invalid_argument("n_qubits must be between 1 and 40");
+        }
+        if ((uint64_t(1) << n_qubits) < static_cast<uint64_t>(num_ranks)) {
+            throw std::invalid_argument("more ranks than basis states");
+        }
+        if (rank_command.empty()) {
+            throw std::invalid_argument("rank_command must name the rank entry point");
+        }
+        static std::atomic<int> run_counter{0};
+        const std::string name = "/grover_sim_" + std::to_string(getpid()) + "_" + std::to_string(run_counter++);
+        
+        // Job segment: parameters, matches, then per-rank result blocks
+        DistributedJob job{static_cast<uint64_t>(n_qubits), static_cast<uint64_t>(std::max(iterations, 0)),
+                           static_cast<uint64_t>(std::max(shots, 0)), seed, matches.size(),
+                           static_cast<uint64_t>(num_ranks)};
+        const size_t job_bytes = job.size_bytes();
+        const std::string job_name = name + "_job";
+        int fd = shm_open(job_name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+        if (fd < 0) throw std::runtime_error("shm_open failed for " + job_name);
+        void* mapping = ftruncate(fd, static_cast<off_t>(job_bytes)) == 0
+            ? mmap(nullptr, job_bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0) : MAP_FAILED;
+        close(fd);
+        if (mapping == MAP_FAILED) {
+            shm_unlink(job_name.c_str());
+            throw std::runtime_error("failed to map job segment " + job_name);
+        }
+        std::memcpy(mapping, &job, sizeof(job));
+        int64_t* job_matches = job.matches(mapping);
+        for (size_t i = 0; i < matches.size(); ++i) job_matches[i] = matches[i];
+        try {
+            ShmCommunicator::create_segment(name, num_ranks);
+        } catch (...) {
+            munmap(mapping, job_bytes);
+            shm_unlink(job_name.c_str());
+            throw;
+        }
+        
+        std::vector<pid_t> children;
+        for (int rank = 0; rank < num_ranks; ++rank) {
+            std::vector<std::string> args(rank_command);
+            args.push_back(name);
+            args.push_back(std::to_string(rank));
+            std::vector<char*> argv;
+            for (auto& arg : args) argv.push_back(&arg[0]);
+            argv.push_back(nullptr);
+            pid_t pid;
+            if (posix_spawnp(&pid, argv[0], nullptr, nullptr, argv.data(), environ) != 0) break;
+            children.push_back(pid);
+        }
+        
+        // Reap our own ranks only (the host may have other children); if any
+        // fails, release the others from their barriers
+        bool failed = children.size() != static_cast<size_t>(num_ranks);
+        std::unique_ptr<ShmCommunicator> control;
+        if (failed && !children.empty()) {
+            control.reset(new ShmCommunicator(name, 0));
+            control->abort();
+        }
+        while (!children.empty()) {
+            bool reaped = false;
+            for (size_t c = 0; c < children.size();) {
+                int status = 0;
+                const pid_t pid = waitpid(children[c], &status, WNOHANG);
+                if (pid == 0 || (pid < 0 && errno == EINTR)) {
+                    ++c;
+                    continue;
+                }
+                if (pid < 0 || !WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+                    if (!failed) {
+                        control.reset(new ShmCommunicator(name, 0));
+                        control->abort();
+                    }
+                    failed = true;
+                }
+                children.erase(children.begin() + c);
+                reaped = true;
+            }
+            if (!reaped && !children.empty()) std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        control.reset();
+        ShmCommunicator::remove_segment(name);
+        shm_unlink(job_name.c_str());
+        
+        std::unordered_map<std::string, int> counts;
+        if (!failed) {
+            for (int rank = 0; rank < num_ranks; ++rank) {
+                const uint64_t* in = job.results(mapping, rank);
+                for (uint64_t k = 0; k < in[0]; ++k) {
+                    counts[basis_state_label(in[1 + 2 * k], n_qubits)] += static_cast<int>(in[2 + 2 * k]);
+                }
+            }
+        }
+        munmap(mapping, job_bytes);
+        if (failed) throw std::runtime_error("distributed simulation rank failed");
+        return counts;
+#else
+        (void)n_qubits; (void)matches; (void)iterations; (void)num_ranks; (void)shots; (void)seed; (void)rank_command;
+        throw std::runtime_error("distributed simulation requires POSIX shared memory");
+#endif
+    }
+    
+    /**
+     * Body of one simulate_distributed rank, run in its own process: reads the
+     * job published under `name`, simulates this rank's slice and writes its
+     * samples back
+     */
+    static void run_distributed_rank(const std::string& name, int rank) {
+#if defined(__unix__) || defined(__APPLE__)
+        const std::string job_name = name + "_job";
+        int fd = shm_open(job_name.c_str(), O_RDWR, 0600);
+        if (fd < 0) throw std::runtime_error("shm_open failed for " + job_name);
+        DistributedJob job;
+        if (pread(fd, &job, sizeof(job), 0) != static_cast<ssize_t>(sizeof(job))) {
+            close(fd);
+            throw std::runtime_error("cannot read job segment " + job_name);
+        }
+        const size_t job_bytes = job.size_bytes();
+        void* mapping = mmap(nullptr, job_bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        close(fd);
+        if (mapping == MAP_FAILED) throw std::runtime_error("failed to map job segment " + job_name);
+        try {
+            if (rank < 0 || static_cast<uint64_t>(rank) >= job.num_ranks) throw std::invalid_argument("rank out of range");
+            const int64_t* job_matches = job.matches(mapping);
+            std::vector<int> matches(job_matches, job_matches + job.num_matches);
+            ShmCommunicator comm(name, rank);
+            DistributedGroverSimulator sim(comm, static_cast<int>(job.n_qubits), matches);
+            sim.iterate(static_cast<int>(job.iterations));
+            auto samples = sim.sample(static_cast<int>(job.shots), job.seed);
+            uint64_t* out = job.results(mapping, rank);
+            out[0] = samples.size();
+            for (size_t k = 0; k < samples.size(); ++k) {
+                out[1 + 2 * k] = samples[k].first;
+                out[2 + 2 * k] = static_cast<uint64_t>(samples[k].second);
+            }
+        } catch (...) {
+            munmap(mapping, job_bytes);
+            throw;
+        }
+        munmap(mapping, job_bytes);
+#else
+        (void)name; (void)rank;
+        throw std::runtime_error("distributed simulation requires POSIX shared memory");
+#endif
+    }
+    
+    /**
+     * Noisy Grover simulation by quantum trajectories (Monte Carlo
+     * wavefunction). Each trajectory evolves a pure state, sampling Pauli and
+     * amplitude-damping jumps after every layer, and contributes an equal
+     * share of the shots. Trajectory t is seeded from (seed, t) and the
+     * per-trajectory counts are summed, so results do not depend on the
+     * number of threads. Trajectories are tasks on the shared work-stealing
+     * pool (num_threads = 0 uses the tuned thread count). Returns counts in
+     * the same format as run().
+     */
+    std::unordered_map<std::string, int> simulate_noisy(int n_qubits, const std::vector<int>& matches,
+                                                        int iterations, const NoiseModel& noise,
+                                                        int shots = 1000, int trajectories = 100,
+                                                        uint64_t seed = 42, int num_threads = 0) {
+        trajectories = std::max(1, std::min(trajectories, std::max(shots, 1)));
+        if (num_threads <= 0) num_threads = tuned().scan_threads;
+        
+        auto run_trajectory = [&](int t) {
+            std::seed_seq seq{seed, static_cast<uint64_t>(t)};
+            std::mt19937_64 rng(seq);
+            std::uniform_real_distribution<double> uniform(0.0, 1.0);
+            
+            GroverSimulator sim(n_qubits, matches);
+            auto apply_noise = [&]() {
+                for (int q = 0; q < n_qubits; ++q) {
+                    if (noise.depolarizing > 0.0 && uniform(rng) < noise.depolarizing) {
+                        sim.apply_pauli(q, "XYZ"[std::uniform_int_distribution<int>(0, 2)(rng)]);
+                    }
+                    if (noise.amplitude_damping > 0.0) {
+                        sim.apply_amplitude_damping(q, noise.amplitude_damping, uniform(rng));
+                    }
+                }
+            };
+            for (int k = 0; k < iterations; ++k) {
+                sim.apply_oracle();
+                apply_noise();
+                sim.apply_diffusion();
+                apply_noise();
+            }
+            
+            const int my_shots = shots / trajectories + (t < shots % trajectories ? 1 : 0);
+            auto counts = sim.sample(my_shots, rng());
+            if (noise.readout_error <= 0.0) return counts;
+            
+            std::unordered_map<std::string, int> observed;
+            for (const auto& [state, hits] : counts) {
+                for (int h = 0; h < hits; ++h) {
+                    std::string read = state;
+                    for (char& bit : read) {
+                        if (uniform(rng) < noise.readout_error) bit = bit == '0' ? '1' : '0';
+                    }
+                    observed[read]++;
+                }
+            }
+            return observed;
+        };
+        
+        std::vector<std::unordered_map<std::string, int>> results(trajectories);
+        std::function<void(size_t)> run_task = [&](size_t t) { results[t] = run_trajectory(static_cast<int>(t)); };
+        if (num_threads <= 1 || trajectories == 1) {
+            for (int t = 0; t < trajectories; ++t) run_task(t);
+        } else {
+            pool(num_threads)->run(trajectories, run_task);
+        }
+        
+        std::unordered_map<std::string, int> counts;
+        for (const auto& partial : results) {
+            for (const auto& [state, hits] : partial) counts[state] += hits;
+        }
+        return counts;
+    }
+    
+    /**
+     * Statistical analysis of measurement results
+     */
+    std::unordered_map<std::string, double> analyze_measurement_statistics(
+        const std::unordered_map<std::string, int>& counts,
+        const std::vector<int>& expected_matches,
+        int total_shots) {
+        
+        std::unordered_map<std::string, double> stats;
+        
+        int total_match_shots = 0;
+        int max_count = 0;
+        std::string most_frequent_state;
+        
+        for (const auto& [state, count] : counts) {
+            if (count > max_count) {
+                max_count = count;
+                most_frequent_state = state;
+            }
+            
+            // Check if this state corresponds to a match
+            // (This would need position decoding logic)
+            total_match_shots += count;
+        }
+        
+        stats["success_probability"] = static_cast<double>(total_match_shots) / total_shots;
+        stats["max_amplitude"] = static_cast<double>(max_count) / total_shots;
+        stats["entropy"] = calculate_shannon_entropy(counts, total_shots);
+        stats["num_unique_states"] = static_cast<double>(counts.size());
+        
+        return stats;
+    }
+    
+private:
+    /**
+     * Outcome distribution of t-qubit phase estimation on G|s>: an equal
+     * mixture of the Fejer kernels centred on the eigenphases +-theta/pi
+     */
+    static std::vector<double> phase_estimation_distribution(double N, double M, int t) {
+        const double theta = std::asin(std::sqrt(M / N));
+        const double T = std::ldexp(1.0, t);
+        std::vector<double> outcome(static_cast<size_t>(T));
+        for (size_t y = 0; y < outcome.size(); ++y) {
+            double p = 0.0;
+            for (double phase : {theta / M_PI, -theta / M_PI}) {
+                const double delta = phase - static_cast<double>(y) / T;
+                const double denom = std::sin(M_PI * delta);
+                p += std::fabs(denom) < 1e-12 ? 1.0 : std::pow(std::sin(M_PI * T * delta) / (T * denom), 2);
+            }
+            outcome[y] = 0.5 * p;
+        }
+        return outcome;
+    }
+    
+    static double counting_estimate(double N, size_t y, int t) {
+        return N * std::pow(std::sin(M_PI * static_cast<double>(y) / std::ldexp(1.0, t)), 2);
+    }
+    
+    static double counting_error_bound(double N, double estimate, int t) {
+        const double T = std::ldexp(1.0, t);
+        return 2.0 * M_PI * std::sqrt(std::max(0.0, estimate * (N - estimate))) / T + M_PI * M_PI * N / (T * T);
+    }
+    
+    static constexpr int kCorpusTasksPerThread = 8;  // Slack for stealing to even out
+    static constexpr size_t kCalibrationBases = size_t(8) << 20;
+    
+    /**
+     * Time the scan kernels on random data: the fastest thread count for a
+     * large scan (fewer threads unless more are 5% faster), the length from
+     * which two threads beat one (each thread then gets at least half of it),
+     * and the corpus task size with the best throughput on skewed records
+     */
+    static tuning::Profile calibrate() {
+        tuning::Profile profile;
+        profile.cpus = tuning::hardware_threads();
+        profile.source = "calibrated";
+        
+        std::mt19937_64 rng(12345);
+        std::string data(kCalibrationBases, 'A');
+        for (char& c : data) c = "ACGT"[rng() & 3];
+        const std::string pattern = "ACGTAC";
+        auto serial_scan = [&](size_t length) {
+            std::vector<int> matches;
+            scan_range(data.data(), pattern, 0, length - pattern.size() + 1, matches);
+        };
+        auto parallel_scan = [&](size_t length, int threads) {
+            std::vector<size_t> bounds(threads + 1);
+            for (int t = 0; t <= threads; ++t) bounds[t] = (length - pattern.size() + 1) * t / threads;
+            scan_chunks(data.data(), pattern, bounds, nullptr, [](int) {});
+        };
+        
+        const double serial = tuning::best_time(2, [&]() { serial_scan(data.size()); });
+        profile.scan_serial_mbps = data.size() / 1e6 / serial;
+        std::vector<int> candidates;
+        for (int threads = 2; threads < profile.cpus; threads *= 2) candidates.push_back(threads);
+        if (profile.cpus > 1) candidates.push_back(profile.cpus);
+        double best = serial;
+        for (int threads : candidates) {
+            const double time = tuning::best_time(2, [&]() { parallel_scan(data.size(), threads); });
+            if (time < 0.95 * best) {
+                best = time;
+                profile.scan_threads = threads;
+            }
+        }
+        
+        if (profile.scan_threads > 1) {
+            for (size_t length = 1 << 12; length <= data.size(); length *= 2) {
+                const double one = tuning::best_time(3, [&]() { serial_scan(length); });
+                const double two = tuning::best_time(3, [&]() { parallel_scan(length, 2); });
+                if (two < one) {
+                    profile.scan_parallel_threshold = length;
+                    profile.scan_min_chunk = length / 2;
+                    break;
+                }
+            }
+            
+            // Records from 100 bases to 1 Mbp, log-uniform, over the same data
+            SequenceCorpus corpus;
+            for (size_t start = 0; start < data.size();) {
+                const size_t length = std::min<size_t>(data.size() - start,
+                                                       static_cast<size_t>(100 * std::pow(1e4, (rng() % 1000) / 1000.0)));
+                corpus.add("", data.substr(start, length));
+                start += length;
+            }
+            WorkStealingPool workers(profile.scan_threads);
+            double best_corpus = std::numeric_limits<double>::infinity();
+            for (uint64_t task = 1 << 12; task <= (1 << 20); task *= 4) {
+                const double time = tuning::best_time(2, [&]() {
+                    search_corpus(corpus, pattern, nullptr, profile.scan_threads, task, &workers);
+                });
+                if (time < best_corpus) {
+                    best_corpus = time;
+                    profile.corpus_task_windows = task;
+                }
+            }
+        }
+        return profile;
+    }
+    
+    static uint64_t windows_in(uint64_t length, size_t pattern_len) {
+        return length >= pattern_len ? length - pattern_len + 1 : 0;
+    }
+    
+    /**
+     * Shared worker pool, rebuilt when the thread count changes; callers hold
+     * a reference so a rebuild never pulls it out from under a running search
+     */
+    std::shared_ptr<WorkStealingPool> pool(int num_threads) {
+        std::lock_guard<std::mutex> lock(pool_mutex_);
+        if (!pool_ || pool_->size() != num_threads) {
+            pool_ = std::make_shared<WorkStealingPool>(num_threads);
+        }
+        return pool_;
+    }
+    
+    std::mutex pool_mutex_;
+    std::shared_ptr<WorkStealingPool> pool_;
+    
+    static void check_mask(const SequenceMask* mask, size_t sequence_length) {
+        if (mask && mask->length() != sequence_length) {
+            throw std::invalid_argument("mask length does not match the sequence length");
+        }
+    }
+    
+    /**
+     * Call scan(a, b) over the sub-ranges of window starts [begin, end) whose
+     * pattern_len window is free of masked bases (all of it without a mask)
+     */
+    template <class Scan>
+    static void scan_unmasked(const SequenceMask* mask, size_t pattern_len, size_t begin, size_t end, Scan&& scan) {
+        if (!mask) {
+            if (begin < end) scan(begin, end);
+            return;
+        }
+        mask->for_each_clear_run(begin, end + pattern_len - 1, [&](size_t a, size_t b) {
+            const size_t stop = b - a >= pattern_len ? std::min(end, b - pattern_len + 1) : a;
+            if (a < stop) scan(a, stop);
+        });
+    }
+    
+    /**
+     * Append each start position in [begin, end) where pattern occurs while
+     * matches holds fewer than max_matches; returns how many occur in total
+     */
+    template <class Index>
+    static uint64_t scan_range(const char* sequence, const std::string& pattern, size_t begin, size_t end,
+                               std::vector<Index>& matches, size_t max_matches = SIZE_MAX) {
+        const size_t pattern_len = pattern.length();
+        uint64_t found = 0;
+        for (size_t i = begin; i < end; ++i) {
+            bool match = true;
+            for (size_t j = 0; j < pattern_len; ++j) {
+                if (sequence[i + j] != pattern[j]) {
+                    match = false;
+                    break;
+                }
+            }
+            if (match) {
+                ++found;
+                if (matches.size() < max_matches) matches.push_back(static_cast<Index>(i));
+            }
+        }
+        return found;
+    }
+    
+    /**
+     * Parallel scan where worker t covers window starts [bounds[t], bounds[t + 1]).
+     * Chunks are ordered, so each worker's matches go to its prefix-sum offset
+     * in one pre-sized output, which comes out sorted with no merge or sort.
+     */
+    template <class OnStart>
+    static std::vector<int> scan_chunks(const char* sequence, const std::string& pattern,
+                                        const std::vector<size_t>& bounds, const SequenceMask* mask,
+                                        OnStart&& on_start) {
+        const int num_threads = static_cast<int>(bounds.size()) - 1;
+        std::vector<std::vector<int>> local(num_threads);
+        std::vector<std::future<void>> scanning;
+        for (int t = 0; t < num_threads; ++t) {
+            scanning.push_back(std::async(std::launch::async, [&, t]() {
+                on_start(t);
+                scan_unmasked(mask, pattern.length(), bounds[t], bounds[t + 1], [&](size_t begin, size_t end) {
+                    scan_range(sequence, pattern, begin, end, local[t]);
+                });
+            }));
+        }
+        for (auto& future : scanning) {
+            future.get();
+        }
+        
+        std::vector<size_t> offsets(num_threads + 1, 0);
+        for (int t = 0; t < num_threads; ++t) {
+            offsets[t + 1] = offsets[t] + local[t].size();
+        }
+        
+        std::vector<int> matches(offsets.back());
+        std::vector<std::future<void>> writing;
+        for (int t = 0; t < num_threads; ++t) {
+            writing.push_back(std::async(std::launch::async, [&, t]() {
+                std::copy(local[t].begin(), local[t].end(), matches.begin() + offsets[t]);
+                std::vector<int>().swap(local[t]);
+            }));
+        }
+        for (auto& future : writing) {
+            future.get();
+        }
+        return matches;
+    }
+    
+    /**
+     * Calculate Shannon entropy of measurement distribution
+     */
+    double calculate_shannon_entropy(const std::unordered_map<std::string, int>& counts, int total_shots) {
+        double entropy = 0.0;
+        
+        for (const auto& [state, count] : counts) {
+            if (count > 0) {
+                double probability = static_cast<double>(count) / total_shots;
+                entropy -= probability * std::log2(probability);
+            }
+        }
+        
+        return entropy;
+    }
+};
+
+/**
+ * Positional k-mer index over a corpus: for every k-mer code, the ascending
+ * global positions where it occurs, in CSR form (4^k + 1 offsets, then
+ * 8 bytes per indexed base). An exact search for a motif of at least k ACGT
+ * bases reads the positions of the motif's rarest k-mer and checks each
+ * candidate in place, instead of scanning the corpus.
+ */
+class KmerIndex {
+public:
+    static constexpr int kMaxK = 12;
+    
+    /**
+     * The tables are PageBuffers (huge pages above the threshold), shared by
+     * copies of the index
+     */
+    KmerIndex(const SequenceCorpus& corpus, int k) : k_(k) {
+        if (k < 1 || k > kMaxK) throw std::invalid_argument("index k must be between 1 and 12");
+        auto tables = std::make_shared<Tables>();
+        PageBuffer<uint64_t>& offsets = tables->offsets;
+        offsets = PageBuffer<uint64_t>(num_buckets() + 1);
+        std::fill(offsets.data(), offsets.data() + offsets.size(), 0);
+        auto for_each = [&](auto&& fn) {
+            for (size_t r = 0; r < corpus.num_records(); ++r) {
+                const uint64_t start = corpus.starts()[r];
+                seqops::for_each_kmer(corpus.data() + start, corpus.starts()[r + 1] - start, k, false,
+                                      [&](size_t i, uint64_t kmer) { fn(start + i, kmer); });
+            }
+        };
+        for_each([&](uint64_t, uint64_t kmer) { ++offsets[kmer + 1]; });
+        for (size_t b = 1; b < offsets.size(); ++b) offsets[b] += offsets[b - 1];
+        PageBuffer<uint64_t>& positions = tables->positions;
+        positions = PageBuffer<uint64_t>(offsets[num_buckets()]);
+        std::vector<uint64_t> cursor(offsets.data(), offsets.data() + num_buckets());
+        for_each([&](uint64_t position, uint64_t kmer) { positions[cursor[kmer]++] = position; });
+        offsets_ = offsets.data();
+        positions_ = positions.data();
+        backing_ = std::move(tables);
+    }
+    
+    /**
+     * Index over borrowed tables (4^k + 1 offsets, then the positions) that
+     * backing keeps alive
+     */
+    static KmerIndex view(int k, const uint64_t* offsets, const uint64_t* positions,
+                          std::shared_ptr<const void> backing) {
+        KmerIndex index;
+        index.k_ = k;
+        index.offsets_ = offsets;
+        index.positions_ = positions;
+        index.backing_ = std::move(backing);
+        return index;
+    }
+    
+    int k() const { return k_; }
+    size_t num_buckets() const { return size_t(1) << (2 * k_); }
+    const uint64_t* offsets() const { return offsets_; }  // num_buckets() + 1 entries
+    const uint64_t* positions() const { return positions_; }
+    size_t num_positions() const { return offsets()[num_buckets()]; }
+    size_t size_bytes() const { return (num_buckets() + 1 + num_positions()) * sizeof(uint64_t); }
+    
+    /**
+     * Whether search() can answer this pattern
+     */
+    bool covers(const std::string& pattern) const {
+        if (pattern.size() < static_cast<size_t>(k_)) return false;
+        for (char c : pattern) {
+            if (alphabet::code(c) == alphabet::kNoCode) return false;
+        }
+        return true;
+    }
+    
+    /**
+     * Exact matches of a covered pattern: appends the first max_hits to hits
+     * in (record, offset) order and returns the total. With a mask (over the
+     * corpus in global coordinates), matches touching a masked base are skipped.
+     */
+    uint64_t search(const SequenceCorpus& corpus, const std::string& pattern, size_t max_hits,
+                    CorpusHits& hits, const SequenceMask* mask = nullptr) const {
+        if (mask && mask->length() != corpus.total_length()) {
+            throw std::invalid_argument("mask length does not match the sequence length");
+        }
+        const size_t L = pattern.size();
+        const uint64_t* offsets = this->offsets();
+        const uint64_t* positions = this->positions();
+        size_t best_shift = 0;
+        uint64_t best_kmer = 0, best_count = ~uint64_t(0);
+        seqops::for_each_kmer(pattern.data(), L, k_, false, [&](size_t shift, uint64_t kmer) {
+            const uint64_t count = offsets[kmer + 1] - offsets[kmer];
+            if (count < best_count) {
+                best_count = count;
+                best_shift = shift;
+                best_kmer = kmer;
+            }
+        });
+        
+        const uint64_t* starts = corpus.starts();
+        uint64_t total = 0;
+        size_t record = 0;
+        for (uint64_t i = offsets[best_kmer]; i < offsets[best_kmer + 1]; ++i) {
+            if (positions[i] < best_shift) continue;
+            const uint64_t position = positions[i] - best_shift;
+            if (position >= corpus.total_length() || L > corpus.total_length() - position) continue;  // Untrusted (shared) tables
+            while (starts[record + 1] <= position) ++record;  // Candidates ascend, so records do too
+            if (position + L > starts[record + 1] || std::memcmp(corpus.data() + position, pattern.data(), L) != 0 ||
+                (mask && mask->any(position, L))) {
+                continue;
+            }
+            if (total++ < max_hits) {
+                hits.record_ids.push_back(static_cast<uint32_t>(record));
+                hits.offsets.push_back(position - starts[record]);
+            }
+        }
+        return total;
+    }
+    
+private:
+    KmerIndex() = default;
+    
+    struct Tables {
+        PageBuffer<uint64_t> offsets;
+        PageBuffer<uint64_t> positions;
+    };
+    
+    int k_ = 0;
+    const uint64_t* offsets_ = nullptr;    // Bucket b is positions_[offsets_[b], offsets_[b + 1])
+    const uint64_t* positions_ = nullptr;  // Global window starts, ascending within each bucket
+    std::shared_ptr<const void> backing_;  // Owns the tables: built Tables or a shared segment
+};
+
+/**
+ * Micro-batching front end for motif queries over one corpus. Concurrent
+ * submit() calls queue up; a dispatcher thread waits until max_batch queries
+ * are pending or the oldest has waited max_wait_us, then serves the batch
+ * together: identical patterns once, patterns the index covers by lookup and
+ * the rest in a single Aho-Corasick pass. Each caller still gets only its own
+ * result. max_wait_us bounds the latency added, and max_batch bounds the work
+ * per pass. The corpus, index and optional mask must outlive the scheduler.
+ */
+class BatchScheduler {
+public:
+    struct Result {
+        uint64_t total = 0;  // All matches; hits holds at most max_hits of them
+        CorpusHits hits;
+    };
+    
+    /**
+     * num_threads = 0 uses the tuned thread count for scans; with a mask,
+     * matches touching masked bases are left out of every result
+     */
+    BatchScheduler(const SequenceCorpus& corpus, const KmerIndex* index, uint32_t max_wait_us, size_t max_batch,
+                   int num_threads, const SequenceMask* mask = nullptr)
+        : corpus_(corpus), index_(index), mask_(mask) {
+        if (mask && mask->length() != corpus.total_length()) {
+            throw std::invalid_argument("mask length does not match the sequence length");
+        }
+        configure(max_wait_us, max_batch);
+        const tuning::Profile profile = GroverAccelerator::tuned();
+        num_threads_ = num_threads > 0 ? num_threads : profile.scan_threads;
+        min_task_ = profile.corpus_task_windows;
+        if (num_threads_ > 1) workers_ = std::make_unique<WorkStealingPool>(num_threads_);
+        dispatcher_ = std::thread([this]() { dispatch_loop(); });
+    }
+    
+    ~BatchScheduler() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stopping_ = true;
+        }
+        wake_.notify_all();
+        dispatcher_.join();
+    }
+    
+    BatchScheduler(const BatchScheduler&) = delete;
+    BatchScheduler& operator=(const BatchScheduler&) = delete;
+    
+    /**
+     * Change the knobs; applies from the next batch
+     */
+    void configure(uint32_t max_wait_us, size_t max_batch) {
+        if (max_batch < 1) throw std::invalid_argument("max_batch must be at least 1");
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            max_wait_ = std::chrono::microseconds(max_wait_us);
+            max_batch_ = max_batch;
+        }
+        wake_.notify_all();
+    }
+    
+    std::future<Result> submit(std::string pattern, size_t max_hits) {
+        Request request{std::move(pattern), max_hits, {}, std::chrono::steady_clock::now()};
+        std::future<Result> result = request.promise.get_future();
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (stopping_) throw std::runtime_error("batch scheduler is shutting down");
+            queue_.push_back(std::move(request));
+        }
+        wake_.notify_all();
+        return result;
+    }
+    
+    Result search(std::string pattern, size_t max_hits) {
+        return submit(std::move(pattern), max_hits).get();
+    }
+    
+    std::unordered_map<std::string, double> stats() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return {{"requests", static_cast<double>(requests_)},
+                {"batches", static_cast<double>(batches_)},
+                {"coalesced", static_cast<double>(coalesced_)},
+                {"scan_passes", static_cast<double>(scan_passes_)},
+                {"mean_batch", batches_ ? static_cast<double>(requests_) / batches_ : 0.0},
+                {"mean_wait_us", requests_ ? wait_micros_ / requests_ : 0.0},
+                {"mean_latency_us", requests_ ? latency_micros_ / requests_ : 0.0},
+                {"max_wait_us", static_cast<double>(max_wait_.count())},
+                {"max_batch", static_cast<double>(max_batch_)}};
+    }
+    
+private:
+    struct Request {
+        std::string pattern;
+        size_t max_hits;
+        std::promise<Result> promise;
+        std::chrono::steady_clock::time_point queued;
+    };
+    
+    void dispatch_loop() {
+        std::unique_lock<std::mutex> lock(mutex_);
+        for (;;) {
+            wake_.wait(lock, [this]() { return stopping_ || !queue_.empty(); });
+            if (stopping_) break;
+            wake_.wait_until(lock, queue_.front().queued + max_wait_,
+                             [this]() { return stopping_ || queue_.size() >= max_batch_; });
+            if (stopping_) break;
+            
+            const size_t n = std::min(queue_.size(), max_batch_);
+            std::vector<Request> batch(std::make_move_iterator(queue_.begin()),
+                                       std::make_move_iterator(queue_.begin() + n));
+            queue_.erase(queue_.begin(), queue_.begin() + n);
+            const auto dispatched = std::chrono::steady_clock::now();
+            lock.unlock();
+            
+            const BatchCounts counts = serve(batch);
+            const auto done = std::chrono::steady_clock::now();
+            
+            lock.lock();
+            ++batches_;
+            requests_ += n;
+            coalesced_ += n - counts.unique;
+            scan_passes_ += counts.scan_passes;
+            for (const auto& request : batch) {
+                wait_micros_ += std::chrono::duration<double, std::micro>(dispatched - request.queued).count();
+                latency_micros_ += std::chrono::duration<double, std::micro>(done - request.queued).count();
+            }
+        }
+        for (auto& request : queue_) {
+            request.promise.set_exception(std::make_exception_ptr(std::runtime_error("batch scheduler stopped")));
+        }
+        queue_.clear();
+    }
+    
+    struct BatchCounts {
+        size_t unique = 0;
+        size_t scan_passes = 0;
+    };
+    
+    BatchCounts serve(std::vector<Request>& batch) {
+        // Coalesce identical patterns, each fetching as many hits as its greediest caller wants
+        std::unordered_map<std::string, size_t> slot;
+        std::vector<const std::string*> patterns;
+        std::vector<size_t> wanted;
+        std::vector<size_t> request_slot(batch.size());
+        for (size_t i = 0; i < batch.size(); ++i) {
+            auto [it, inserted] = slot.emplace(batch[i].pattern, patterns.size());
+            if (inserted) {
+                patterns.push_back(&it->first);
+                wanted.push_back(0);
+            }
+            request_slot[i] = it->second;
+            wanted[it->second] = std::max(wanted[it->second], batch[i].max_hits);
+        }
+        
+        BatchCounts counts;
+        counts.unique = patterns.size();
+        try {
+            std::vector<Result> results(patterns.size());
+            std::vector<std::string> scanned;
+            std::vector<size_t> scanned_slot;
+            for (size_t u = 0; u < patterns.size(); ++u) {
+                if (patterns[u]->empty()) continue;
+                if (index_ && index_->covers(*patterns[u])) {
+                    results[u].total = index_->search(corpus_, *patterns[u], wanted[u], results[u].hits, mask_);
+                } else {
+                    scanned.push_back(*patterns[u]);
+                    scanned_slot.push_back(u);
+                }
+            }
+            if (!scanned.empty()) {
+                // Scans keep only as many hits as the greediest caller wants, counting the rest
+                std::vector<size_t> scanned_wanted;
+                for (size_t u : scanned_slot) scanned_wanted.push_back(wanted[u]);
+                std::vector<CorpusHits> hits;
+                std::vector<uint64_t> totals(scanned.size(), 0);
+                if (scanned.size() == 1) {
+                    hits.push_back(GroverAccelerator::search_corpus(corpus_, scanned[0], mask_, num_threads_,
+                                                                    min_task_, workers_.get(), scanned_wanted[0],
+                                                                    &totals[0]));
+                } else {
+                    hits = GroverAccelerator::search_corpus_multi(corpus_, AhoCorasick(scanned), num_threads_,
+                                                                  min_task_, workers_.get(), &scanned_wanted, &totals,
+                                                                  mask_);
+                }
+                counts.scan_passes = 1;
+                for (size_t s = 0; s < scanned.size(); ++s) {
+                    Result& result = results[scanned_slot[s]];
+                    result.total = totals[s];
+                    result.hits = std::move(hits[s]);
+                }
+            }
+            
+            for (size_t i = 0; i < batch.size(); ++i) {
+                const Result& shared = results[request_slot[i]];
+                const size_t keep = std::min<size_t>(batch[i].max_hits, shared.hits.offsets.size());
+                Result own;
+                own.total = shared.total;
+                own.hits.record_ids.assign(shared.hits.record_ids.begin(), shared.hits.record_ids.begin() + keep);
+                own.hits.offsets.assign(shared.hits.offsets.begin(), shared.hits.offsets.begin() + keep);
+                batch[i].promise.set_value(std::move(own));
+            }
+        } catch (...) {
+            for (auto& request : batch) {
+                try {
+                    request.promise.set_exception(std::current_exception());
+                } catch (const std::future_error&) {
+                    // Already answered
+                }
+            }
+        }
+        return counts;
+    }
+    
+    const SequenceCorpus& corpus_;
+    const KmerIndex* index_;
+    const SequenceMask* mask_;
+    int num_threads_;
+    uint64_t min_task_;
+    std::unique_ptr<WorkStealingPool> workers_;
+    std::thread dispatcher_;
+    std::mutex mutex_;
+    std::condition_variable wake_;
+    std::deque<Request> queue_;
+    std::chrono::microseconds max_wait_{0};
+    size_t max_batch_ = 1;
+    bool stopping_ = false;
+    uint64_t requests_ = 0;
+    uint64_t batches_ = 0;
+    uint64_t coalesced_ = 0;
+    uint64_t scan_passes_ = 0;
+    double wait_micros_ = 0.0;
+    double latency_micros_ = 0.0;
+};
+
+#if defined(__unix__) || defined(__APPLE__)
+/**
+ * Corpus and optional k-mer index published once into a named POSIX
+ * shared-memory segment, so every worker process on the host maps the same
+ * physical pages instead of holding its own copy. Attaching maps the segment
+ * read-only; the corpus and index are views into it, valid while any copy of
+ * the SharedReference (or of its corpus/index) is alive.
+ *
+ * Layout: a Header, then 64-byte aligned sections for the record starts,
+ * the sequence bytes, the NUL-terminated record names and, when indexed,
+ * the index offsets and positions. The magic is written last, so a segment
+ * still being filled is refused.
+ */
+class SharedReference {
+public:
+    /**
+     * Create the segment `name` (e.g. "/grover-hg38") holding corpus and, when
+     * given, an index built over it; fails if the name is taken
+     */
+    static void publish(const std::string& name, const SequenceCorpus& corpus, const KmerIndex* index) {
+        Header header{};
+        header.num_records = corpus.num_records();
+        header.total_length = corpus.total_length();
+        header.index_k = index ? static_cast<uint64_t>(index->k()) : 0;
+        for (const auto& record_name : corpus.names()) header.names_bytes += record_name.size() + 1;
+        const uint64_t num_offsets = index ? index->num_buckets() + 1 : 0;
+        const uint64_t num_positions = index ? index->num_positions() : 0;
+        header.starts_at = align(sizeof(Header));
+        header.data_at = align(header.starts_at + (header.num_records + 1) * sizeof(uint64_t));
+        header.names_at = align(header.data_at + header.total_length);
+        header.offsets_at = align(header.names_at + header.names_bytes);
+        header.positions_at = header.offsets_at + num_offsets * sizeof(uint64_t);
+        header.size = header.positions_at + num_positions * sizeof(uint64_t);
+        
+        int fd = shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+        if (fd < 0) throw std::runtime_error("shm_open failed for " + name + " (already published?)");
+        if (ftruncate(fd, static_cast<off_t>(header.size)) != 0) {
+            close(fd);
+            shm_unlink(name.c_str());
+            throw std::runtime_error("ftruncate failed for " + name);
+        }
+#ifdef __linux__
+        // ftruncate does not reserve tmpfs pages: without this a full /dev/shm
+        // turns the copies below into SIGBUS instead of an exception
+        if (posix_fallocate(fd, 0, static_cast<off_t>(header.size)) != 0) {
+            close(fd);
+            shm_unlink(name.c_str());
+            throw std::runtime_error("not enough shared memory for " + name + " (" +
+                                     std::to_string(header.size) + " bytes)");
+        }
+#endif
+        void* p = mmap(nullptr, header.size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        close(fd);
+        if (p == MAP_FAILED) {
+            shm_unlink(name.c_str());
+            throw std::runtime_error("mmap failed for " + name);
+        }
+        char* base = static_cast<char*>(p);
+        std::memcpy(base + header.starts_at, corpus.starts(), (header.num_records + 1) * sizeof(uint64_t));
+        std::memcpy(base + header.data_at, corpus.data(), header.total_length);
+        char* names = base + header.names_at;
+        for (const auto& record_name : corpus.names()) {
+            std::memcpy(names, record_name.c_str(), record_name.size() + 1);
+            names += record_name.size() + 1;
+        }
+        if (index) {
+            std::memcpy(base + header.offsets_at, index->offsets(), num_offsets * sizeof(uint64_t));
+            std::memcpy(base + header.positions_at, index->positions(), num_positions * sizeof(uint64_t));
+        }
+        std::memcpy(p, &header, sizeof(Header));
+        std::atomic_thread_fence(std::memory_order_release);
+        std::memcpy(p, kMagic, sizeof(kMagic));
+        munmap(p, header.size);
+    }
+    
+    static void unlink(const std::string& name) {
+        shm_unlink(name.c_str());
+    }
+    
     /**
-     * Fast DNA sequence encoding - converts positions to binary representations
+     * Map a published segment read-only
      */
-    std::vector<std::string> encode_positions(int num_candidates, int n_qubits) {
-        std::vector<std::string> encodings;
-        encodings.reserve(num_candidates);
+    static SharedReference attach(const std::string& name) {
+        int fd = shm_open(name.c_str(), O_RDONLY, 0);
+        if (fd < 0) throw std::runtime_error("no shared reference named " + name);
+        struct stat info;
+        if (fstat(fd, &info) != 0 || static_cast<size_t>(info.st_size) < sizeof(Header)) {
+            close(fd);
+            throw std::runtime_error("shared reference " + name + " is not ready");
+        }
+        const size_t size = static_cast<size_t>(info.st_size);
+        void* p = mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+        close(fd);
+        if (p == MAP_FAILED) throw std::runtime_error("mmap failed for " + name);
+        std::shared_ptr<const void> backing(p, [size](const void* q) { munmap(const_cast<void*>(q), size); });
         
-        for (int pos = 0; pos < num_candidates; ++pos) {
-            std::string binary;
-            binary.reserve(n_qubits);
-            
-            // Convert to binary with zero padding
-            for (int bit = n_qubits - 1; bit >= 0; --bit) {
-                binary += ((pos >> bit) & 1) ? '1' : '0';
-            }
-            encodings.push_back(binary);
+        Header header;
+        std::memcpy(&header, p, sizeof(Header));
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (std::memcmp(header.magic, kMagic, sizeof(kMagic)) != 0) {
+            throw std::runtime_error("shared reference " + name + " is not ready or not a reference");
         }
+        if (!valid(header, static_cast<const char*>(p), size)) {
+            throw std::runtime_error("shared reference " + name + " is corrupt");
+        }
+        const char* base = static_cast<const char*>(p);
+        const uint64_t* starts = reinterpret_cast<const uint64_t*>(base + header.starts_at);
+        const uint64_t* offsets = reinterpret_cast<const uint64_t*>(base + header.offsets_at);
         
-        return encodings;
+        std::vector<std::string> names;
+        names.reserve(header.num_records);
+        for (const char* s = base + header.names_at; names.size() < header.num_records; s += names.back().size() + 1) {
+            names.emplace_back(s);  // valid() found every terminator inside the names section
+        }
+        
+        SharedReference reference;
+        reference.name_ = name;
+        reference.size_ = header.size;
+        reference.corpus_ = SequenceCorpus::view(base + header.data_at, starts, std::move(names), backing);
+        if (header.index_k) {
+            reference.index_.emplace(KmerIndex::view(static_cast<int>(header.index_k), offsets,
+                                                     reinterpret_cast<const uint64_t*>(base + header.positions_at),
+                                                     backing));
+        }
+        reference.backing_ = std::move(backing);
+        return reference;
     }
     
+    const std::string& name() const { return name_; }
+    size_t size_bytes() const { return size_; }
+    const SequenceCorpus& corpus() const { return corpus_; }
+    const KmerIndex* index() const { return index_ ? &*index_ : nullptr; }  // Null when published without one
+    const std::shared_ptr<const void>& backing() const { return backing_; }
+    
+private:
+    static constexpr char kMagic[8] = {'G', 'R', 'V', 'R', 'E', 'F', '0', '1'};
+    
+    struct Header {
+        char magic[8];
+        uint64_t num_records, total_length, index_k, names_bytes;
+        uint64_t starts_at, data_at, names_at, offsets_at, positions_at, size;  // Byte offsets from the segment start
+    };
+    
+    static uint64_t align(uint64_t offset) { return (offset + 63) & ~uint64_t(63); }
+    
     /**
-     * High-performance pattern matching using optimized string search
+     * Whether a segment of `size` mapped bytes holds what its header says:
+     * ordered, aligned, in-bounds sections (checked without uint64 overflow),
+     * non-decreasing record starts and index offsets, and one NUL-terminated
+     * name per record. Index positions are not scanned here (that would touch
+     * the whole table); KmerIndex::search bounds-checks each one it reads.
      */
-    std::vector<int> find_pattern_matches(const std::string& sequence, const std::string& pattern) {
-        std::vector<int> matches;
-        
-        if (pattern.empty() || sequence.empty() || pattern.length() > sequence.length()) {
-            return matches;
+    static bool valid(const Header& header, const char* base, size_t size) {
+        auto fits = [](uint64_t at, uint64_t count, uint64_t width, uint64_t end) {
+            return at <= end && count <= (end - at) / width;
+        };
+        if (header.size > size || header.index_k > KmerIndex::kMaxK || header.num_records >= UINT32_MAX ||
+            header.starts_at < sizeof(Header) || header.starts_at % 8 != 0 || header.offsets_at % 8 != 0 ||
+            !fits(header.starts_at, header.num_records + 1, sizeof(uint64_t), header.data_at) ||
+            !fits(header.data_at, header.total_length, 1, header.names_at) ||
+            !fits(header.names_at, header.names_bytes, 1, header.offsets_at) ||
+            header.offsets_at > header.positions_at || header.positions_at > header.size ||
+            (header.size - header.positions_at) % sizeof(uint64_t) != 0) {
+            return false;
+        }
+        const uint64_t num_offsets = header.index_k ? (uint64_t(1) << (2 * header.index_k)) + 1 : 0;
+        if ((header.positions_at - header.offsets_at) / sizeof(uint64_t) != num_offsets ||
+            (header.positions_at - header.offsets_at) % sizeof(uint64_t) != 0) {
+            return false;
         }
         
-        // Reserve space to avoid reallocations
-        matches.reserve(sequence.length() / 10); // Rough estimate
-        
-        // Boyer-Moore-inspired optimization for DNA sequences
-        const size_t pattern_len = pattern.length();
-        const size_t sequence_len = sequence.length();
+        const uint64_t* starts = reinterpret_cast<const uint64_t*>(base + header.starts_at);
+        if (starts[0] != 0 || starts[header.num_records] != header.total_length) return false;
+        for (uint64_t r = 0; r < header.num_records; ++r) {
+            if (starts[r] > starts[r + 1]) return false;
+        }
         
-        for (size_t i = 0; i <= sequence_len - pattern_len; ++i) {
-            bool match = true;
-            for (size_t j = 0; j < pattern_len; ++j) {
-                if (sequence[i + j] != pattern[j]) {
-                    match = false;
-                    break;
-                }
+        const uint64_t* offsets = reinterpret_cast<const uint64_t*>(base + header.offsets_at);
+        if (num_offsets) {
+            if (offsets[0] != 0 || offsets[num_offsets - 1] != (header.size - header.positions_at) / sizeof(uint64_t)) {
+                return false;
             }
-            if (match) {
-                matches.push_back(static_cast<int>(i));
+            for (uint64_t b = 0; b + 1 < num_offsets; ++b) {
+                if (offsets[b] > offsets[b + 1]) return false;
             }
         }
         
-        return matches;
+        const char* names = base + header.names_at;
+        const char* names_end = names + header.names_bytes;
+        for (uint64_t r = 0; r < header.num_records; ++r) {
+            const void* nul = std::memchr(names, '\0', static_cast<size_t>(names_end - names));
+            if (!nul) return false;
+            names = static_cast<const char*>(nul) + 1;
+        }
+        return true;
     }
     
+    SharedReference() = default;
+    
+    std::string name_;
+    size_t size_ = 0;
+    SequenceCorpus corpus_;
+    std::optional<KmerIndex> index_;
+    std::shared_ptr<const void> backing_;
+};
+
+/**
+ * Local search daemon: holds a corpus and its k-mer index in memory and
+ * answers motif queries on a Unix domain socket, one thread per connection.
+ *
+ * Wire format (little-endian). Every message is a 12-byte header then a
+ * payload of payload_len bytes; a connection may carry many requests.
+ *   request header:  u32 magic 'GRVQ', u16 version (1), u16 op, u32 payload_len
+ *   response header: u32 magic 'GRVR', u16 status (0 ok, 1 bad request, 2 error), u16 0, u32 payload_len
+ *   kPing:   empty request and response
+ *   kSearch: request u32 max_hits, u32 flags (0), pattern bytes
+ *            response u64 total, u32 returned, u32 record_id[returned], u64 offset[returned]
+ *            (max_hits is capped at kMaxReplyHits so the reply length fits in u32)
+ *   kInfo:   response "key=value" lines
+ *   kNames:  request optional u32 record_id[]; response the names of those
+ *            records (all records when the request is empty), one per line
+ * Errors carry a UTF-8 message as the payload; a reply that would not fit in
+ * a u32 length is refused as a bad request.
+ */
+class SearchServer {
+public:
+    static constexpr uint32_t kRequestMagic = 0x51565247;   // "GRVQ"
+    static constexpr uint32_t kResponseMagic = 0x52565247;  // "GRVR"
+    static constexpr uint16_t kVersion = 1;
+    static constexpr uint32_t kMaxPayload = 1 << 20;
+    static constexpr uint32_t kMaxReplyHits = (UINT32_MAX - 12) / 12;  // u32 id + u64 offset per hit
+    enum Op : uint16_t { kPing = 0, kSearch = 1, kInfo = 2, kNames = 3 };
+    enum Status : uint16_t { kOk = 0, kBadRequest = 1, kError = 2 };
+    
     /**
-     * Parallel pattern matching for large sequences
+     * index_k = 0 serves every query by scanning
      */
-    std::vector<int> find_pattern_matches_parallel(const std::string& sequence, const std::string& pattern, int num_threads = 4) {
-        if (pattern.empty() || sequence.empty() || pattern.length() > sequence.length()) {
-            return std::vector<int>();
+    SearchServer(SequenceCorpus corpus, int index_k) : corpus_(std::move(corpus)) {
+        if (index_k > 0) index_ = std::make_unique<KmerIndex>(corpus_, index_k);
+        GroverAccelerator::tuned();  // Calibrate now rather than on the first scan
+    }
+    
+    /**
+     * Serve an attached shared reference without copying it or rebuilding its index
+     */
+    explicit SearchServer(const SharedReference& reference) : corpus_(reference.corpus()) {
+        if (reference.index()) index_ = std::make_unique<KmerIndex>(*reference.index());
+        GroverAccelerator::tuned();
+    }
+    
+    ~SearchServer() { stop(); }
+    
+    SearchServer(const SearchServer&) = delete;
+    SearchServer& operator=(const SearchServer&) = delete;
+    
+    const SequenceCorpus& corpus() const { return corpus_; }
+    int index_k() const { return index_ ? index_->k() : 0; }
+    bool running() const { return listen_fd_ >= 0; }
+    const std::string& socket_path() const { return path_; }
+    
+    /**
+     * Bind the socket (replacing a stale one) and accept connections on a
+     * background thread. The socket is bound inside a private 0700 directory
+     * next to path, made owner-only and then renamed into place, so it is
+     * never reachable with umask permissions.
+     */
+    void start(const std::string& path) {
+        if (listen_fd_ >= 0) throw std::runtime_error("server is already running");
+        socket_address(path);
+        struct stat existing;
+        if (::lstat(path.c_str(), &existing) == 0) {
+            if (!S_ISSOCK(existing.st_mode)) throw std::runtime_error("not a socket, refusing to replace: " + path);
         }
-        
-        const size_t sequence_len = sequence.length();
-        const size_t pattern_len = pattern.length();
-        const size_t search_len = sequence_len - pattern_len + 1;
-        const size_t chunk_size = search_len / num_threads;
-        
-        std::vector<std::future<std::vector<int>>> futures;
-        
-        for (int t = 0; t < num_threads; ++t) {
-            size_t start = t * chunk_size;
-            size_t end = (t == num_threads - 1) ? search_len : (t + 1) * chunk_size;
-            
-            futures.push_back(std::async(std::launch::async, [&, start, end]() {
-                std::vector<int> local_matches;
-                for (size_t i = start; i < end; ++i) {
-                    bool match = true;
-                    for (size_t j = 0; j < pattern_len; ++j) {
-                        if (sequence[i + j] != pattern[j]) {
-                            match = false;
-                            break;
-                        }
-                    }
-                    if (match) {
-                        local_matches.push_back(static_cast<int>(i));
-                    }
-                }
-                return local_matches;
-            }));
+        const size_t slash = path.rfind('/');
+        std::string private_dir = (slash == std::string::npos ? std::string(".") : path.substr(0, slash + 1)) + ".grover_XXXXXX";
+        if (!::mkdtemp(&private_dir[0])) throw std::runtime_error("cannot create a private directory next to " + path);
+        const std::string staged = private_dir + "/s";
+        const int fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+        bool listening = false;
+        if (fd >= 0) {
+            try {
+                sockaddr_un address = socket_address(staged);
+                listening = ::bind(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) == 0 &&
+                            ::chmod(staged.c_str(), 0600) == 0 &&  // Owner only
+                            ::listen(fd, 64) == 0 &&
+                            ::rename(staged.c_str(), path.c_str()) == 0;  // Replaces a stale socket atomically
+            } catch (const std::invalid_argument&) {
+                // Staged path too long for sun_path; reported below
+            }
         }
-        
-        // Collect results from all threads
-        std::vector<int> all_matches;
-        for (auto& future : futures) {
-            auto local_matches = future.get();
-            all_matches.insert(all_matches.end(), local_matches.begin(), local_matches.end());
+        if (!listening) {
+            if (fd >= 0) ::close(fd);
+            ::unlink(staged.c_str());
+            ::rmdir(private_dir.c_str());
+            throw std::runtime_error("cannot listen on " + path);
         }
-        
-        // Sort since parallel execution might return out-of-order results
-        std::sort(all_matches.begin(), all_matches.end());
-        
-        return all_matches;
+        ::rmdir(private_dir.c_str());
+        path_ = path;
+        stopping_ = false;
+        listen_fd_ = fd;
+        accept_thread_ = std::thread([this]() { accept_loop(); });
     }
     
     /**
-     * Fast diagonal matrix construction for oracle
+     * Stop accepting, close open connections and wait for their threads
      */
-    std::vector<std::complex<double>> build_oracle_diagonal(const std::vector<int>& matches, int database_size) {
-        std::vector<std::complex<double>> diagonal(database_size, std::complex<double>(1.0, 0.0));
-        
-        // Mark matching positions with -1 phase
-        for (int match : matches) {
-            if (match < database_size) {
-                diagonal[match] = std::complex<double>(-1.0, 0.0);
-            }
+    void stop() {
+        if (listen_fd_ < 0) return;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stopping_ = true;
+            for (int fd : clients_) ::shutdown(fd, SHUT_RDWR);
         }
-        
-        return diagonal;
+        // Wake accept() with a throwaway connection
+        const int wake = ::socket(AF_UNIX, SOCK_STREAM, 0);
+        sockaddr_un address = socket_address(path_);
+        if (wake >= 0) {
+            ::connect(wake, reinterpret_cast<sockaddr*>(&address), sizeof(address));
+            ::close(wake);
+        }
+        accept_thread_.join();
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            idle_.wait(lock, [this]() { return active_ == 0; });
+        }
+        ::close(listen_fd_);
+        ::unlink(path_.c_str());
+        listen_fd_ = -1;
     }
     
     /**
-     * Calculate optimal number of Grover iterations
+     * Route scans through a BatchScheduler, so concurrent queries the index
+     * cannot answer share one pass; max_batch = 0 turns batching off.
+     * Only while stopped.
      */
-    int calculate_optimal_iterations(int total_items, int marked_items) {
-        if (marked_items <= 0 || total_items <= 0) {
-            return 1;
+    void set_batching(uint32_t max_wait_us, size_t max_batch) {
+        if (running()) throw std::runtime_error("stop the server before changing batching");
+        batcher_.reset();
+        batch_wait_us_ = max_wait_us;
+        batch_max_ = max_batch;
+        if (max_batch > 0) {
+            batcher_ = std::make_unique<BatchScheduler>(corpus_, index_.get(), max_wait_us, max_batch, 0,
+                                                        mask_ ? &*mask_ : nullptr);
         }
-        
-        double ratio = static_cast<double>(total_items) / static_cast<double>(marked_items);
-        int iterations = static_cast<int>(std::floor((M_PI / 4.0) * std::sqrt(ratio)));
-        
-        return std::max(1, iterations);
     }
     
     /**
-     * Statistical analysis of measurement results
+     * Keep a copy of mask (nullptr clears it) and drop matches touching its
+     * masked bases from every later query. Only while stopped.
      */
-    std::unordered_map<std::string, double> analyze_measurement_statistics(
-        const std::unordered_map<std::string, int>& counts,
-        const std::vector<int>& expected_matches,
-        int total_shots) {
-        
-        std::unordered_map<std::string, double> stats;
-        
-        int total_match_shots = 0;
-        int max_count = 0;
-        std::string most_frequent_state;
-        
-        for (const auto& [state, count] : counts) {
-            if (count > max_count) {
-                max_count = count;
-                most_frequent_state = state;
-            }
-            
-            // Check if this state corresponds to a match
-            // (This would need position decoding logic)
-            total_match_shots += count;
+    void set_mask(const SequenceMask* mask) {
+        if (running()) throw std::runtime_error("stop the server before changing the mask");
+        if (mask && mask->length() != corpus_.total_length()) {
+            throw std::invalid_argument("mask length does not match the sequence length");
         }
-        
-        stats["success_probability"] = static_cast<double>(total_match_shots) / total_shots;
-        stats["max_amplitude"] = static_cast<double>(max_count) / total_shots;
-        stats["entropy"] = calculate_shannon_entropy(counts, total_shots);
-        stats["num_unique_states"] = static_cast<double>(counts.size());
-        
-        return stats;
+        batcher_.reset();  // It points at the old mask
+        if (mask) {
+            mask_ = *mask;
+        } else {
+            mask_.reset();
+        }
+        set_batching(batch_wait_us_, batch_max_);
     }
     
-private:
     /**
-     * Calculate Shannon entropy of measurement distribution
+     * One search as the daemon runs it: the index when it covers the
+     * pattern, else a scan of every record (batched when enabled)
      */
-    double calculate_shannon_entropy(const std::unordered_map<std::string, int>& counts, int total_shots) {
-        double entropy = 0.0;
-        
-        for (const auto& [state, count] : counts) {
-            if (count > 0) {
-                double probability = static_cast<double>(count) / total_shots;
-                entropy -= probability * std::log2(probability);
+    uint64_t search(const std::string& pattern, size_t max_hits, CorpusHits& hits) {
+        const auto start = std::chrono::steady_clock::now();
+        uint64_t total;
+        const SequenceMask* mask = mask_ ? &*mask_ : nullptr;
+        const bool indexed = index_ && index_->covers(pattern);
+        if (indexed) {
+            total = index_->search(corpus_, pattern, max_hits, hits, mask);
+        } else if (batcher_) {
+            BatchScheduler::Result result = batcher_->search(pattern, max_hits);
+            total = result.total;
+            hits = std::move(result.hits);
+        } else {
+            hits = GroverAccelerator::search_corpus(corpus_, pattern, mask, 1, ~uint64_t(0) >> 1, nullptr,
+                                                    max_hits, &total);
+        }
+        const double micros = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+        std::lock_guard<std::mutex> lock(mutex_);
+        ++queries_;
+        indexed_queries_ += indexed;
+        search_micros_ += micros;
+        return total;
+    }
+    
+    std::unordered_map<std::string, double> stats() {
+        std::unordered_map<std::string, double> result;
+        if (batcher_) {
+            for (const auto& [key, value] : batcher_->stats()) result["batch_" + key] = value;
+        }
+        std::lock_guard<std::mutex> lock(mutex_);
+        result.insert({{"records", static_cast<double>(corpus_.num_records())},
+                {"total_length", static_cast<double>(corpus_.total_length())},
+                {"index_k", static_cast<double>(index_k())},
+                {"index_bytes", index_ ? static_cast<double>(index_->size_bytes()) : 0.0},
+                {"queries", static_cast<double>(queries_)},
+                {"indexed_queries", static_cast<double>(indexed_queries_)},
+                {"mean_search_us", queries_ ? search_micros_ / queries_ : 0.0},
+                {"connections", static_cast<double>(connections_)}});
+        return result;
+    }
+    
+private:
+    static sockaddr_un socket_address(const std::string& path) {
+        sockaddr_un address{};
+        if (path.empty() || path.size() >= sizeof(address.sun_path)) {
+            throw std::invalid_argument("socket path must be 1-" + std::to_string(sizeof(address.sun_path) - 1) + " bytes");
+        }
+        address.sun_family = AF_UNIX;
+        std::memcpy(address.sun_path, path.data(), path.size());
+        return address;
+    }
+    
+    void accept_loop() {
+        for (;;) {
+            const int fd = ::accept(listen_fd_, nullptr, nullptr);
+            if (fd < 0) {
+                if (errno == EINTR || errno == ECONNABORTED) continue;
+                return;
             }
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (stopping_) {
+                ::close(fd);
+                return;
+            }
+            clients_.push_back(fd);
+            ++active_;
+            ++connections_;
+            std::thread([this, fd]() { serve_connection(fd); }).detach();
         }
-        
-        return entropy;
     }
+    
+    static bool read_all(int fd, void* buffer, size_t bytes) {
+        char* p = static_cast<char*>(buffer);
+        while (bytes > 0) {
+            const ssize_t n = ::read(fd, p, bytes);
+            if (n < 0 && errno == EINTR) continue;
+            if (n <= 0) return false;
+            p += n;
+            bytes -= static_cast<size_t>(n);
+        }
+        return true;
+    }
+    
+    static bool write_all(int fd, const void* buffer, size_t bytes) {
+#ifdef MSG_NOSIGNAL
+        const int flags = MSG_NOSIGNAL;  // A vanished client must not SIGPIPE the daemon
+#else
+        const int flags = 0;
+#endif
+        const char* p = static_cast<const char*>(buffer);
+        while (bytes > 0) {
+            const ssize_t n = ::send(fd, p, bytes, flags);
+            if (n < 0 && errno == EINTR) continue;
+            if (n <= 0) return false;
+            p += n;
+            bytes -= static_cast<size_t>(n);
+        }
+        return true;
+    }
+    
+    template <typename T>
+    static void append(std::string& out, T value) {
+        out.append(reinterpret_cast<const char*>(&value), sizeof(T));
+    }
+    
+    template <typename T>
+    static void append(std::string& out, const std::vector<T>& values) {
+        out.append(reinterpret_cast<const char*>(values.data()), values.size() * sizeof(T));
+    }
+    
+    Status handle(uint16_t op, const std::string& request, std::string& response) {
+        switch (op) {
+        case kPing:
+            return kOk;
+        case kSearch: {
+            if (request.size() < 8) {
+                response = "search request needs max_hits, flags and a pattern";
+                return kBadRequest;
+            }
+            uint32_t max_hits;
+            std::memcpy(&max_hits, request.data(), 4);
+            const std::string pattern = request.substr(8);
+            if (pattern.empty()) {
+                response = "empty pattern";
+                return kBadRequest;
+            }
+            CorpusHits hits;
+            const uint64_t total = search(pattern, std::min(max_hits, kMaxReplyHits), hits);
+            append<uint64_t>(response, total);
+            append<uint32_t>(response, static_cast<uint32_t>(hits.offsets.size()));
+            append(response, hits.record_ids);
+            append(response, hits.offsets);
+            return kOk;
+        }
+        case kInfo:
+            for (const auto& [key, value] : stats()) {
+                std::ostringstream line;
+                line << key << '=' << std::setprecision(15) << value << '\n';
+                response += line.str();
+            }
+            return kOk;
+        case kNames: {
+            if (request.size() % 4 != 0) {
+                response = "names request must be a list of u32 record ids";
+                return kBadRequest;
+            }
+            const size_t wanted = request.size() / 4;
+            for (size_t i = 0; i < (wanted ? wanted : corpus_.num_records()); ++i) {
+                uint32_t r = static_cast<uint32_t>(i);
+                if (wanted) std::memcpy(&r, request.data() + 4 * i, 4);
+                if (r >= corpus_.num_records()) {
+                    response = "record id " + std::to_string(r) + " out of range";
+                    return kBadRequest;
+                }
+                response += corpus_.name(r);
+                response += '\n';
+            }
+            return kOk;
+        }
+        default:
+            response = "unknown op " + std::to_string(op);
+            return kBadRequest;
+        }
+    }
+    
+    void serve_connection(int fd) {
+        std::string request, response;
+        for (;;) {
+            uint32_t header[3];
+            if (!read_all(fd, header, sizeof(header))) break;
+            const uint32_t magic = header[0];
+            const uint16_t version = static_cast<uint16_t>(header[1] & 0xFFFF);
+            const uint16_t op = static_cast<uint16_t>(header[1] >> 16);
+            const uint32_t length = header[2];
+            if (magic != kRequestMagic || version != kVersion || length > kMaxPayload) break;  // Not our protocol
+            request.resize(length);
+            if (length > 0 && !read_all(fd, &request[0], length)) break;
+            
+            response.clear();
+            Status status;
+            try {
+                status = handle(op, request, response);
+            } catch (const std::exception& e) {
+                response = e.what();
+                status = kError;
+            }
+            if (response.size() > UINT32_MAX) {
+                response = "reply exceeds the 4 GiB protocol limit";
+                status = kBadRequest;
+            }
+            const uint32_t reply[3] = {kResponseMagic, status, static_cast<uint32_t>(response.size())};
+            if (!write_all(fd, reply, sizeof(reply)) || !write_all(fd, response.data(), response.size())) break;
+        }
+        std::lock_guard<std::mutex> lock(mutex_);
+        clients_.erase(std::find(clients_.begin(), clients_.end(), fd));  // Before close: stop() never sees a reused fd
+        ::close(fd);
+        --active_;
+        idle_.notify_all();
+    }
+    
+    SequenceCorpus corpus_;
+    std::unique_ptr<KmerIndex> index_;
+    std::optional<SequenceMask> mask_;
+    std::unique_ptr<BatchScheduler> batcher_;  // After corpus_, index_ and mask_, which it reads, so it is destroyed first
+    uint32_t batch_wait_us_ = 200;
+    size_t batch_max_ = 0;
+    std::string path_;
+    int listen_fd_ = -1;
+    std::thread accept_thread_;
+    std::mutex mutex_;
+    std::condition_variable idle_;
+    std::vector<int> clients_;
+    int active_ = 0;
+    bool stopping_ = false;
+    uint64_t connections_ = 0;
+    uint64_t queries_ = 0;
+    uint64_t indexed_queries_ = 0;
+    double search_micros_ = 0.0;
 };
+#endif
 
 /**
  * Standalone utility functions
@@ -229,35 +5445,498 @@ namespace utils {
      * Validate DNA sequence (only contains A, T, G, C)
      */
     bool is_valid_dna(const std::string& sequence) {
-        for (char base : sequence) {
-            if (base != 'A' && base != 'T' && base != 'G' && base != 'C') {
-                return false;
+        // Branch-free within a block so it vectorises; stop at the first bad block
+        constexpr size_t kBlock = 256;
+        for (size_t begin = 0; begin < sequence.size(); begin += kBlock) {
+            const size_t end = std::min(sequence.size(), begin + kBlock);
+            uint8_t all_bases = 1;
+            for (size_t i = begin; i < end; ++i) {
+                all_bases &= alphabet::kind(sequence[i]) == alphabet::kBase;
             }
+            if (!all_bases) return false;
         }
         return true;
     }
     
+    /**
+     * Reverse complement (IUPAC-aware, case-preserving)
+     */
+    std::string reverse_complement(const std::string& sequence) {
+        std::string rc(sequence.size(), '\0');
+        seqops::reverse_complement(sequence.data(), sequence.size(), rc.data());
+        return rc;
+    }
+    
+    /**
+     * Frames +1, +2, +3 on the sequence, then -1, -2, -3 on its reverse complement
+     */
+    std::vector<std::string> translate_six_frames(const std::string& sequence) {
+        const std::string rc = reverse_complement(sequence);
+        std::vector<std::string> frames;
+        for (const std::string* strand : {&sequence, &rc}) {
+            for (size_t offset = 0; offset < 3; ++offset) {
+                frames.push_back(seqops::translate(strand->data(), strand->size(), offset));
+            }
+        }
+        return frames;
+    }
+    
     /**
      * Calculate GC content of DNA sequence
      */
     double calculate_gc_content(const std::string& sequence) {
         if (sequence.empty()) return 0.0;
         
-        int gc_count = 0;
+        size_t gc_count = 0;
         for (char base : sequence) {
-            if (base == 'G' || base == 'C') {
-                gc_count++;
-            }
+            gc_count += alphabet::gc(base);
         }
         
         return static_cast<double>(gc_count) / sequence.length();
     }
 }
 
+/**
+ * Hand a vector to NumPy without copying; the array owns it through a capsule
+ */
+template <typename T>
+py::array_t<T> to_numpy(std::vector<T>&& values) {
+    auto* owned = new std::vector<T>(std::move(values));
+    py::capsule owner(owned, [](void* p) { delete static_cast<std::vector<T>*>(p); });
+    return py::array_t<T>(owned->size(), owned->data(), owner);
+}
+
+template <typename T>
+py::array_t<T> to_numpy(PageBuffer<T>&& values) {
+    auto* owned = new PageBuffer<T>(std::move(values));
+    py::capsule owner(owned, [](void* p) { delete static_cast<PageBuffer<T>*>(p); });
+    return py::array_t<T>(owned->size(), owned->data(), owner);
+}
+
+/**
+ * Run job() on the shared AsyncExecutor and return a concurrent.futures.Future
+ * that receives convert(result) or the job's exception. The job runs without
+ * the GIL; keep_alive holds Python arguments the job reads by pointer until it
+ * finishes. Cancelling the future before the job starts skips it.
+ */
+template <typename Job, typename Convert>
+py::object submit_async(Job job, Convert convert, py::object keep_alive = py::none()) {
+    struct Pending {
+        py::object future;
+        py::object keep_alive;
+    };
+    py::object future = py::module_::import("concurrent.futures").attr("Future")();
+    // Python objects are only touched, and finally released, with the GIL held
+    auto* pending = new Pending{future, std::move(keep_alive)};
+    AsyncExecutor::shared().submit([pending, job = std::move(job), convert = std::move(convert)]() mutable {
+        {
+            py::gil_scoped_acquire gil;
+            if (!pending->future.attr("set_running_or_notify_cancel")().template cast<bool>()) {
+                delete pending;
+                return;
+            }
+        }
+        std::exception_ptr error;
+        std::optional<decltype(job())> result;
+        try {
+            result.emplace(job());
+        } catch (...) {
+            error = std::current_exception();
+        }
+        
+        py::gil_scoped_acquire gil;
+        try {
+            if (error) std::rethrow_exception(error);
+            pending->future.attr("set_result")(convert(std::move(*result)));
+        } catch (py::error_already_set& e) {
+            pending->future.attr("set_exception")(e.value());
+        } catch (const std::exception& e) {
+            // Same mapping as pybind11's synchronous exception translation
+            const char* type = dynamic_cast<const std::invalid_argument*>(&e) ? "ValueError"
+                             : dynamic_cast<const std::out_of_range*>(&e) ? "IndexError"
+                             : dynamic_cast<const std::bad_alloc*>(&e) ? "MemoryError" : "RuntimeError";
+            pending->future.attr("set_exception")(py::module_::import("builtins").attr(type)(e.what()));
+        } catch (...) {
+            // Anything else would escape the executor thread and terminate the process
+            pending->future.attr("set_exception")(
+                py::module_::import("builtins").attr("RuntimeError")("unknown exception in async job"));
+        }
+        delete pending;
+    });
+    return future;
+}
+
+template <typename Job>
+py::object submit_async(Job job, py::object keep_alive = py::none()) {
+    return submit_async(std::move(job), [](auto&& result) { return py::cast(std::move(result)); },
+                        std::move(keep_alive));
+}
+
+/**
+ * Read-only NumPy view of a MatchTable column that shares the column storage
+ */
+template <typename T>
+py::array_t<T> column_view(const MatchTable& table, const std::vector<T>& column) {
+    auto* owner = new std::shared_ptr<const MatchTable::Columns>(table.share());
+    py::capsule base(owner, [](void* p) { delete static_cast<std::shared_ptr<const MatchTable::Columns>*>(p); });
+    py::array_t<T> view(column.size(), column.data(), base);
+    view.attr("setflags")(py::arg("write") = false);
+    return view;
+}
+
+// Arrow PyCapsule destructors: release the structure unless a consumer moved it out
+void release_schema_capsule(PyObject* capsule) {
+    auto* schema = static_cast<ArrowSchema*>(PyCapsule_GetPointer(capsule, "arrow_schema"));
+    if (schema->release) schema->release(schema);
+    delete schema;
+}
+
+void release_array_capsule(PyObject* capsule) {
+    auto* array = static_cast<ArrowArray*>(PyCapsule_GetPointer(capsule, "arrow_array"));
+    if (array->release) array->release(array);
+    delete array;
+}
+
+void release_stream_capsule(PyObject* capsule) {
+    auto* stream = static_cast<ArrowArrayStream*>(PyCapsule_GetPointer(capsule, "arrow_array_stream"));
+    if (stream->release) stream->release(stream);
+    delete stream;
+}
+
+py::tuple corpus_hits_to_python(CorpusHits&& hits) {
+    return py::make_tuple(to_numpy(std::move(hits.record_ids)), to_numpy(std::move(hits.offsets)));
+}
+
 // Python bindings
 PYBIND11_MODULE(grover_accelerator, m) {
     m.doc() = "High-performance C++ accelerator for Grover DNA search";
     
+    // NUMA-placed sequence buffer
+    py::class_<PlacedSequence>(m, "PlacedSequence")
+        .def(py::init<const std::string&, int, const std::string&>(),
+             "Copy a sequence into a buffer first-touched by pinned workers",
+             py::arg("sequence"), py::arg("num_threads") = 4, py::arg("policy") = "partition")
+        .def("__len__", &PlacedSequence::length)
+        .def_property_readonly("num_threads", &PlacedSequence::num_threads)
+        .def_property_readonly("policy", &PlacedSequence::policy)
+        .def_property_readonly("page_size", &PlacedSequence::page_size,
+                               "Page size guaranteed for the buffer (hugetlbfs or base pages)")
+        .def("worker_nodes", &PlacedSequence::worker_nodes,
+             "NUMA node each worker is placed on");
+    
+    // 2-bit packed sequence; the buffer protocol exposes the words without copying
+    py::class_<PackedSequence>(m, "PackedSequence", py::buffer_protocol())
+        .def(py::init<const std::string&>(), "Pack an ACGT sequence at 2 bits per base",
+             py::arg("sequence"))
+        .def("__len__", &PackedSequence::length)
+        .def("to_string", &PackedSequence::to_string, "Unpack to an ASCII string")
+        .def("reverse_complement", &PackedSequence::reverse_complement,
+             "Reverse complement computed word-wise on the packed form")
+        .def("canonical_kmers", [](const PackedSequence& self, int k) { return to_numpy(self.canonical_kmers(k)); },
+             "Canonical 2-bit k-mer at each window start as a uint64 array", py::arg("k"))
+        .def_buffer([](PackedSequence& self) {
+            return py::buffer_info(const_cast<uint64_t*>(self.words().data()), sizeof(uint64_t),
+                                   py::format_descriptor<uint64_t>::format(), 1,
+                                   {static_cast<py::ssize_t>(self.words().size())},
+                                   {static_cast<py::ssize_t>(sizeof(uint64_t))}, true);
+        });
+    
+    // k-mer spectrum; arrays are copied out once into NumPy
+    py::class_<KmerSpectrum>(m, "KmerSpectrum")
+        .def_property_readonly("k", &KmerSpectrum::k)
+        .def_property_readonly("canonical", &KmerSpectrum::canonical)
+        .def_property_readonly("total", &KmerSpectrum::total, "Number of k-mer occurrences counted")
+        .def_property_readonly("distinct", &KmerSpectrum::distinct, "Number of distinct k-mers")
+        .def("kmers", [](const KmerSpectrum& self) { return to_numpy(std::vector<uint64_t>(self.kmers())); },
+             "Sorted distinct k-mers as 2-bit codes (uint64)")
+        .def("counts", [](const KmerSpectrum& self) { return to_numpy(std::vector<uint64_t>(self.counts())); },
+             "Count of each k-mer in kmers() order")
+        .def("dense", [](const KmerSpectrum& self) { return to_numpy(self.dense()); },
+             "Counts indexed by k-mer code, 4^k entries (k <= 12)")
+        .def("count", &KmerSpectrum::count_of, "Occurrences of one k-mer", py::arg("kmer"))
+        .def("histogram", &KmerSpectrum::histogram, "Number of distinct k-mers at each abundance",
+             py::arg("max_count") = 1000);
+    
+    // Low-complexity mask accepted by the pattern searches and oracle builder
+    py::class_<SequenceMask>(m, "SequenceMask")
+        .def(py::init<size_t>(), "Empty mask over length positions", py::arg("length"))
+        .def_static("dust", &SequenceMask::dust, "DUST triplet-score mask of repetitive windows",
+                    py::arg("sequence"), py::arg("window") = 64, py::arg("threshold") = 20)
+        .def_static("entropy", &SequenceMask::entropy, "Mask windows whose base entropy is below min_entropy bits",
+                    py::arg("sequence"), py::arg("window") = 32, py::arg("min_entropy") = 1.5)
+        .def_static("from_intervals", &SequenceMask::from_intervals, "Mask given [begin, end) intervals",
+                    py::arg("length"), py::arg("intervals"))
+        .def("__len__", &SequenceMask::length)
+        .def_property_readonly("masked_bases", &SequenceMask::masked_bases)
+        .def("masked", &SequenceMask::masked, "Whether one position is masked", py::arg("position"))
+        .def("intervals", &SequenceMask::intervals, "Masked spans as [begin, end) tuples")
+        .def("merge", &SequenceMask::merge, "Union another mask into this one", py::arg("other"),
+             py::return_value_policy::reference_internal)
+        .def("to_numpy", [](const SequenceMask& self) {
+            std::vector<uint8_t> flags(self.length());
+            for (size_t i = 0; i < flags.size(); ++i) flags[i] = self.masked(i);
+            return to_numpy(std::move(flags));
+        }, "Per-position masked flags as a uint8 array");
+    
+    // Multi-record corpus searched without crossing record junctions
+    py::class_<SequenceCorpus>(m, "SequenceCorpus")
+        .def(py::init<>())
+        .def(py::init<const std::vector<std::string>&, const std::vector<std::string>&>(),
+             "Corpus of sequences, named by index unless names are given",
+             py::arg("sequences"), py::arg("names") = std::vector<std::string>())
+        .def_static("from_fasta", &SequenceCorpus::from_fasta,
+                    "Load every record of a FASTA file; soft-masked bases are uppercased unless uppercase=False",
+                    py::arg("path"), py::arg("uppercase") = true)
+        .def("add", &SequenceCorpus::add, "Append a record and return its id", py::arg("name"), py::arg("sequence"))
+        .def("__len__", &SequenceCorpus::num_records)
+        .def_property_readonly("num_records", &SequenceCorpus::num_records)
+        .def_property_readonly("total_length", &SequenceCorpus::total_length)
+        .def("name", &SequenceCorpus::name, py::arg("record_id"))
+        .def("record", &SequenceCorpus::record, "Sequence of one record", py::arg("record_id"))
+        .def("record_length", &SequenceCorpus::record_length, py::arg("record_id"))
+        .def("starts", [](const SequenceCorpus& self) { return to_numpy(std::vector<uint64_t>(self.starts(), self.starts() + self.num_records() + 1)); },
+             "Global start of each record followed by the total length (uint64)")
+        .def("sequence", &SequenceCorpus::sequence, "All records concatenated (global coordinates)")
+        .def("locate", &SequenceCorpus::locate, "(record_id, offset) of a global position", py::arg("position"));
+    
+    // Positional k-mer index for exact motif lookups
+    py::class_<KmerIndex>(m, "KmerIndex")
+        .def(py::init<const SequenceCorpus&, int>(), "Index every k-mer position of a corpus",
+             py::arg("corpus"), py::arg("k") = 11)
+        .def_property_readonly("k", &KmerIndex::k)
+        .def_property_readonly("size_bytes", &KmerIndex::size_bytes)
+        .def("covers", &KmerIndex::covers, "Whether the pattern is at least k ACGT bases", py::arg("pattern"))
+        .def("search", [](const KmerIndex& self, const SequenceCorpus& corpus, const std::string& pattern,
+                          size_t max_hits, const SequenceMask* mask) {
+            if (!self.covers(pattern)) throw std::invalid_argument("pattern is not covered by the index");
+            CorpusHits hits;
+            uint64_t total;
+            {
+                py::gil_scoped_release release;
+                total = self.search(corpus, pattern, max_hits, hits, mask);
+            }
+            return py::make_tuple(total, corpus_hits_to_python(std::move(hits)));
+        }, "Exact matches in the indexed corpus; returns (total, (record_ids, offsets)) with at most "
+           "max_hits hits", py::arg("corpus"), py::arg("pattern"), py::arg("max_hits") = size_t(~uint32_t(0)),
+           py::arg("mask") = nullptr);
+    
+    // Columnar match results with zero-copy Arrow export
+    py::class_<MatchTable>(m, "MatchTable")
+        .def(py::init<>())
+        .def("__len__", &MatchTable::size)
+        .def("append", &MatchTable::append, "Add one row", py::arg("record_id"), py::arg("position"),
+             py::arg("strand") = 1, py::arg("score") = 1.0f, py::arg("mismatches") = 0)
+        .def("record_ids", [](const MatchTable& self) { return column_view(self, self.columns().record_ids); },
+             "Read-only uint32 view of the record_id column")
+        .def("positions", [](const MatchTable& self) { return column_view(self, self.columns().positions); },
+             "Read-only uint64 view of the position column")
+        .def("strands", [](const MatchTable& self) { return column_view(self, self.columns().strands); },
+             "Read-only int8 view of the strand column (+1 / -1)")
+        .def("scores", [](const MatchTable& self) { return column_view(self, self.columns().scores); },
+             "Read-only float32 view of the score column")
+        .def("mismatches", [](const MatchTable& self) { return column_view(self, self.columns().mismatches); },
+             "Read-only uint16 view of the mismatches column")
+        // Arrow PyCapsule interface: pyarrow.table(t), polars.from_arrow(t), duckdb etc. import without copying
+        .def("__arrow_c_schema__", [](const MatchTable&) {
+            auto* schema = new ArrowSchema;
+            MatchTable::export_schema(schema);
+            return py::capsule(schema, "arrow_schema", &release_schema_capsule);
+        })
+        .def("__arrow_c_array__", [](const MatchTable& self, py::object /*requested_schema*/) {
+            auto* schema = new ArrowSchema;
+            MatchTable::export_schema(schema);
+            py::capsule schema_capsule(schema, "arrow_schema", &release_schema_capsule);
+            auto* array = new ArrowArray;
+            self.export_array(array);
+            return py::make_tuple(schema_capsule, py::capsule(array, "arrow_array", &release_array_capsule));
+        }, py::arg("requested_schema") = py::none())
+        .def("__arrow_c_stream__", [](const MatchTable& self, py::object /*requested_schema*/) {
+            auto* stream = new ArrowArrayStream;
+            self.export_stream(stream);
+            return py::capsule(stream, "arrow_array_stream", &release_stream_capsule);
+        }, py::arg("requested_schema") = py::none())
+        .def("to_parquet", [](py::object self, const std::string& path, const std::string& compression) {
+            py::module_ pyarrow = py::module_::import("pyarrow");
+            py::module_::import("pyarrow.parquet").attr("write_table")(pyarrow.attr("table")(self), path,
+                                                                        py::arg("compression") = compression);
+        }, "Write a Parquet file through pyarrow (imported from the Arrow export, no copy)",
+             py::arg("path"), py::arg("compression") = "zstd");
+    
+    // Coalesces concurrent queries into batched multi-pattern passes
+    py::class_<BatchScheduler>(m, "BatchScheduler")
+        .def(py::init<const SequenceCorpus&, const KmerIndex*, uint32_t, size_t, int, const SequenceMask*>(),
+             "Batch queries over a corpus (and optional index over it): a batch is dispatched once "
+             "max_batch queries are pending or the oldest has waited max_wait_us; matches touching "
+             "bases set in the optional mask are skipped",
+             py::arg("corpus"), py::arg("index") = nullptr, py::arg("max_wait_us") = 200,
+             py::arg("max_batch") = 64, py::arg("num_threads") = 0, py::arg("mask") = nullptr,
+             py::keep_alive<1, 2>(), py::keep_alive<1, 3>(), py::keep_alive<1, 7>())
+        .def("search", [](BatchScheduler& self, std::string pattern, size_t max_hits) {
+            BatchScheduler::Result result;
+            {
+                py::gil_scoped_release release;
+                result = self.search(std::move(pattern), max_hits);
+            }
+            return py::make_tuple(result.total, corpus_hits_to_python(std::move(result.hits)));
+        }, "Queue a query and wait for its batch; returns (total, (record_ids, offsets)). "
+           "Call from several threads to share batches", py::arg("pattern"),
+             py::arg("max_hits") = size_t(~uint32_t(0)))
+        .def("configure", &BatchScheduler::configure, "Change the latency and batch-size knobs",
+             py::arg("max_wait_us"), py::arg("max_batch"))
+        .def("stats", &BatchScheduler::stats, "Batch counts, coalesced duplicates and mean wait and latency");
+    
+#if defined(__unix__) || defined(__APPLE__)
+    // Reference shared read-only between processes through POSIX shared memory
+    py::class_<SharedReference>(m, "SharedReference")
+        .def_static("publish", [](const std::string& name, const SequenceCorpus& corpus, int index_k) {
+            py::gil_scoped_release release;
+            std::unique_ptr<KmerIndex> index;
+            if (index_k > 0) index = std::make_unique<KmerIndex>(corpus, index_k);
+            SharedReference::publish(name, corpus, index.get());
+        }, "Copy a corpus (and a k-mer index over it unless index_k = 0) into a new shared-memory segment",
+             py::arg("name"), py::arg("corpus"), py::arg("index_k") = 0)
+        .def_static("attach", &SharedReference::attach, "Map a published reference read-only, without copying",
+                    py::arg("name"))
+        .def_static("unlink", &SharedReference::unlink,
+                    "Remove the segment name; mapped copies stay valid until detached", py::arg("name"))
+        .def_property_readonly("name", &SharedReference::name)
+        .def_property_readonly("size_bytes", &SharedReference::size_bytes)
+        .def_property_readonly("corpus", &SharedReference::corpus, py::return_value_policy::reference_internal)
+        .def_property_readonly("index", &SharedReference::index, py::return_value_policy::reference_internal,
+                               "KmerIndex view, or None when published without one")
+        .def("sequence_view", [](const SharedReference& self) {
+            auto* owner = new std::shared_ptr<const void>(self.backing());
+            py::capsule base(owner, [](void* p) { delete static_cast<std::shared_ptr<const void>*>(p); });
+            const SequenceCorpus& corpus = self.corpus();
+            py::array_t<uint8_t> view(corpus.total_length(), reinterpret_cast<const uint8_t*>(corpus.data()), base);
+            view.attr("setflags")(py::arg("write") = false);
+            return view;
+        }, "Read-only uint8 array over the shared sequence bytes (global coordinates)");
+    
+    // Local search daemon on a Unix domain socket
+    py::class_<SearchServer>(m, "SearchServer")
+        .def(py::init([](SequenceCorpus corpus, int index_k) {
+            py::gil_scoped_release release;
+            return std::make_unique<SearchServer>(std::move(corpus), index_k);
+        }), "Serve a copy of the corpus; index_k = 0 disables the k-mer index",
+             py::arg("corpus"), py::arg("index_k") = 11)
+        .def_static("from_fasta", [](const std::string& path, int index_k) {
+            py::gil_scoped_release release;
+            return std::make_unique<SearchServer>(SequenceCorpus::from_fasta(path), index_k);
+        }, "Serve every record of a FASTA file", py::arg("path"), py::arg("index_k") = 11)
+        .def_static("from_shared", [](const std::string& name) {
+            py::gil_scoped_release release;
+            return std::make_unique<SearchServer>(SharedReference::attach(name));
+        }, "Serve a published SharedReference and its index in place", py::arg("name"))
+        .def("start", &SearchServer::start, "Listen on a Unix socket path in the background", py::arg("socket_path"))
+        .def("stop", &SearchServer::stop, "Close the socket and every connection",
+             py::call_guard<py::gil_scoped_release>())
+        .def_property_readonly("running", &SearchServer::running)
+        .def_property_readonly("socket_path", &SearchServer::socket_path)
+        .def_property_readonly("index_k", &SearchServer::index_k)
+        .def_property_readonly("num_records", [](const SearchServer& self) { return self.corpus().num_records(); })
+        .def("search", [](SearchServer& self, const std::string& pattern, size_t max_hits) {
+            CorpusHits hits;
+            uint64_t total;
+            {
+                py::gil_scoped_release release;
+                total = self.search(pattern, max_hits, hits);
+            }
+            return py::make_tuple(total, corpus_hits_to_python(std::move(hits)));
+        }, "In-process query, as the daemon answers it", py::arg("pattern"),
+             py::arg("max_hits") = size_t(~uint32_t(0)))
+        .def("set_batching", &SearchServer::set_batching,
+             "Batch scans of unindexed queries (see BatchScheduler); max_batch = 0 disables. Only while stopped",
+             py::arg("max_wait_us") = 200, py::arg("max_batch") = 64,
+             py::call_guard<py::gil_scoped_release>())
+        .def("set_mask", &SearchServer::set_mask,
+             "Skip matches touching masked bases of corpus.sequence() (the server keeps a copy); "
+             "None clears it. Only while stopped",
+             py::arg("mask"), py::call_guard<py::gil_scoped_release>())
+        .def("stats", &SearchServer::stats, "Query counts and mean search latency");
+#endif
+    
+    // Noise model for trajectory simulation
+    py::class_<NoiseModel>(m, "NoiseModel")
+        .def(py::init<double, double, double>(),
+             "Per-layer depolarizing and amplitude-damping probabilities and per-bit readout error",
+             py::arg("depolarizing") = 0.0, py::arg("amplitude_damping") = 0.0,
+             py::arg("readout_error") = 0.0)
+        .def_readonly("depolarizing", &NoiseModel::depolarizing)
+        .def_readonly("amplitude_damping", &NoiseModel::amplitude_damping)
+        .def_readonly("readout_error", &NoiseModel::readout_error);
+    
+    // Gate-level circuit compiler
+    py::class_<GroverCircuit>(m, "GroverCircuit")
+        .def(py::init<int, const std::vector<int>&, int, const std::string&, bool>(),
+             "Compile a Grover circuit; oracle_method is 'auto', 'mcz' (one multi-controlled Z "
+             "per match) or 'gray' (Gray-code phase network)",
+             py::arg("n_qubits"), py::arg("matches"), py::arg("iterations"),
+             py::arg("oracle_method") = "auto", py::arg("measure") = true)
+        .def_property_readonly("n_qubits", &GroverCircuit::n_qubits)
+        .def_property_readonly("num_ancillas", &GroverCircuit::num_ancillas)
+        .def_property_readonly("iterations", &GroverCircuit::iterations)
+        .def_property_readonly("oracle_method", &GroverCircuit::oracle_method,
+                               "Oracle decomposition actually used")
+        .def("gate_counts", &GroverCircuit::gate_counts, "Gate counts of the unrolled circuit")
+        .def("depth", &GroverCircuit::depth, "Circuit depth over data and ancilla qubits")
+        .def("to_qasm", &GroverCircuit::to_qasm,
+             "OpenQASM 3 source; oracle and diffusion are gate definitions repeated in a for loop "
+             "unless unrolled",
+             py::arg("unrolled") = false)
+        .def_static("cache_info", &GroverCircuit::cache_info,
+                    "Hits, misses and entries of the compiled oracle/diffusion cache")
+        .def_static("clear_cache", &GroverCircuit::clear_cache, "Drop all cached oracles and diffusions");
+    
+    // Native Grover statevector simulator
+    py::class_<GroverSimulator>(m, "GroverSimulator")
+        .def(py::init<int, const std::vector<int>&, const std::string&, bool>(),
+             "Uniform superposition over 2^n_qubits states with the given marked positions; "
+             "a storage_path directory keeps expanded amplitudes in a memory-mapped scratch file "
+             "created there (out-of-core)",
+             py::arg("n_qubits"), py::arg("marked"), py::arg("storage_path") = "",
+             py::arg("compressed") = true)
+        .def_property_readonly("n_qubits", &GroverSimulator::n_qubits)
+        .def_property_readonly("out_of_core", &GroverSimulator::out_of_core)
+        .def_property_readonly("is_compressed", &GroverSimulator::is_compressed,
+                               "True while the state is held as two amplitudes plus the marked set")
+        .def_property_readonly("kernel", &GroverSimulator::kernel,
+                               "Iteration kernel in use: 'compressed', 'specialized' (n <= 16) or 'generic'")
+        .def("expand", &GroverSimulator::expand, "Switch to the full statevector")
+        .def_property_readonly("dimension", &GroverSimulator::dimension)
+        .def("reset", &GroverSimulator::reset, "Prepare the uniform superposition")
+        .def("apply_oracle", &GroverSimulator::apply_oracle, "Phase-flip the marked states")
+        .def("apply_phase_oracle", &GroverSimulator::apply_phase_oracle,
+             "Apply a user-supplied diagonal oracle (expands the state if non-uniform)",
+             py::arg("diagonal"))
+        .def("apply_pauli", &GroverSimulator::apply_pauli, "Apply 'X', 'Y' or 'Z' to one qubit",
+             py::arg("qubit"), py::arg("pauli"))
+        .def("apply_diffusion", &GroverSimulator::apply_diffusion, "Inversion about the mean")
+        .def("iterate", &GroverSimulator::iterate, "Apply Grover iterations",
+             py::arg("iterations"))
+        .def("apply_generalized_iteration", &GroverSimulator::apply_generalized_iteration,
+             "Grover iteration with arbitrary oracle and diffusion phases",
+             py::arg("oracle_phase"), py::arg("diffusion_phase"))
+        .def_static("exact_schedule", &GroverSimulator::exact_schedule,
+                    "(iterations, phase) for exact Grover with num_marked of dimension states",
+                    py::arg("dimension"), py::arg("num_marked"))
+        .def_static("fixed_point_schedule", &GroverSimulator::fixed_point_schedule,
+                    "Yoder-Low-Chuang (oracle_phase, diffusion_phase) pairs for success >= 1 - delta^2",
+                    py::arg("delta"), py::arg("min_fraction"))
+        .def("run_exact", &GroverSimulator::run_exact,
+             "Reset, run exact (phase-matched) Grover and sample",
+             py::arg("shots") = 1000, py::arg("seed") = 42)
+        .def("run_fixed_point", &GroverSimulator::run_fixed_point,
+             "Reset, run fixed-point amplitude amplification and sample",
+             py::arg("delta"), py::arg("min_fraction"), py::arg("shots") = 1000, py::arg("seed") = 42)
+        .def("probabilities", &GroverSimulator::probabilities, "Measurement probability of each state")
+        .def("success_probability", &GroverSimulator::success_probability,
+             "Total probability of measuring a marked state")
+        .def("sample", &GroverSimulator::sample, "Sample measurement counts",
+             py::arg("shots"), py::arg("seed") = 42)
+        .def("run", &GroverSimulator::run, "Reset, iterate and sample measurement counts",
+             py::arg("iterations"), py::arg("shots") = 1000, py::arg("seed") = 42);
+    
     // Main accelerator class
     py::class_<GroverAccelerator>(m, "GroverAccelerator")
         .def(py::init<>())
@@ -266,29 +5945,226 @@ PYBIND11_MODULE(grover_accelerator, m) {
              py::arg("num_candidates"), py::arg("n_qubits"))
         .def("find_pattern_matches", &GroverAccelerator::find_pattern_matches,
              "High-performance pattern matching",
-             py::arg("sequence"), py::arg("pattern"))
+             py::arg("sequence"), py::arg("pattern"), py::arg("mask") = nullptr)
+        .def("find_pattern_matches_iupac", &GroverAccelerator::find_pattern_matches_iupac,
+             "Pattern matching with IUPAC ambiguity codes",
+             py::arg("sequence"), py::arg("pattern"), py::arg("mask") = nullptr)
+        .def("find_pattern_matches_auto", &GroverAccelerator::find_pattern_matches_auto,
+             "Pattern matching with the serial/parallel choice and thread count taken from the tuning profile",
+             py::arg("sequence"), py::arg("pattern"), py::arg("mask") = nullptr)
+        .def_static("tuned_threads", &GroverAccelerator::tuned_threads,
+                    "Threads find_pattern_matches_auto uses for this sequence length", py::arg("sequence_length"))
+        .def("find_pattern_matches_corpus", [](GroverAccelerator& self, const SequenceCorpus& corpus,
+                                               const std::string& pattern, int num_threads, const SequenceMask* mask) {
+            CorpusHits hits;
+            {
+                py::gil_scoped_release release;
+                hits = self.find_pattern_matches_corpus(corpus, pattern, num_threads, mask);
+            }
+            return corpus_hits_to_python(std::move(hits));
+        }, "Load-balanced pattern matching per corpus record; returns (record_ids, offsets) arrays",
+             py::arg("corpus"), py::arg("pattern"), py::arg("num_threads") = 0, py::arg("mask") = nullptr)
+        .def("find_matches_table", &GroverAccelerator::find_matches_table,
+             "Corpus matches on both strands (unless both_strands=False) as a MatchTable",
+             py::arg("corpus"), py::arg("pattern"), py::arg("both_strands") = true, py::arg("num_threads") = 0,
+             py::arg("mask") = nullptr, py::call_guard<py::gil_scoped_release>())
+        .def("find_pattern_matches_multi", [](GroverAccelerator& self, const SequenceCorpus& corpus,
+                                              const std::vector<std::string>& patterns, int num_threads,
+                                              const SequenceMask* mask) {
+            std::vector<CorpusHits> hits;
+            {
+                py::gil_scoped_release release;
+                hits = self.find_pattern_matches_multi(corpus, patterns, num_threads, mask);
+            }
+            py::list result;
+            for (auto& pattern_hits : hits) result.append(corpus_hits_to_python(std::move(pattern_hits)));
+            return result;
+        }, "All patterns in one Aho-Corasick pass; returns a (record_ids, offsets) pair per pattern",
+             py::arg("corpus"), py::arg("patterns"), py::arg("num_threads") = 0, py::arg("mask") = nullptr)
+        // *_async variants run on a native executor and return concurrent.futures.Future
+        // (await with asyncio.wrap_future); each keeps the accelerator and its inputs alive
+        .def("find_pattern_matches_async", [](GroverAccelerator& self, std::string sequence, std::string pattern,
+                                              py::object mask) {
+            const SequenceMask* m = mask.is_none() ? nullptr : mask.cast<const SequenceMask*>();
+            return submit_async([&self, sequence = std::move(sequence), pattern = std::move(pattern), m]() {
+                return self.find_pattern_matches_auto(sequence, pattern, m);
+            }, py::make_tuple(py::cast(&self), mask));
+        }, "find_pattern_matches_auto in the background; returns a Future",
+             py::arg("sequence"), py::arg("pattern"), py::arg("mask") = py::none())
+        .def("find_pattern_matches_corpus_async", [](GroverAccelerator& self, py::object corpus, std::string pattern,
+                                                     int num_threads, py::object mask) {
+            const SequenceCorpus* c = corpus.cast<const SequenceCorpus*>();
+            const SequenceMask* m = mask.is_none() ? nullptr : mask.cast<const SequenceMask*>();
+            return submit_async([&self, c, pattern = std::move(pattern), num_threads, m]() {
+                return self.find_pattern_matches_corpus(*c, pattern, num_threads, m);
+            }, corpus_hits_to_python, py::make_tuple(py::cast(&self), corpus, mask));
+        }, "find_pattern_matches_corpus in the background; returns a Future",
+             py::arg("corpus"), py::arg("pattern"), py::arg("num_threads") = 0, py::arg("mask") = py::none())
+        .def("count_kmers_async", [](GroverAccelerator& self, std::string sequence, int k, bool canonical,
+                                     int num_threads) {
+            return submit_async([&self, sequence = std::move(sequence), k, canonical, num_threads]() {
+                return self.count_kmers(sequence, k, canonical, num_threads);
+            }, py::cast(&self));
+        }, "count_kmers in the background; returns a Future of a KmerSpectrum",
+             py::arg("sequence"), py::arg("k"), py::arg("canonical") = true, py::arg("num_threads") = 4)
+        .def("simulate_async", [](GroverAccelerator&, int n_qubits, std::vector<int> matches, int iterations,
+                                  int shots, uint64_t seed) {
+            return submit_async([n_qubits, matches = std::move(matches), iterations, shots, seed]() {
+                GroverSimulator simulator(n_qubits, matches);
+                return simulator.run(iterations, shots, seed);
+            });
+        }, "Native statevector simulation in the background; returns a Future of counts",
+             py::arg("n_qubits"), py::arg("matches"), py::arg("iterations"), py::arg("shots") = 1000,
+             py::arg("seed") = 42)
+        .def("simulate_noisy_async", [](GroverAccelerator& self, int n_qubits, std::vector<int> matches,
+                                        int iterations, NoiseModel noise, int shots, int trajectories,
+                                        uint64_t seed, int num_threads) {
+            return submit_async([&self, n_qubits, matches = std::move(matches), iterations, noise, shots,
+                                 trajectories, seed, num_threads]() {
+                return self.simulate_noisy(n_qubits, matches, iterations, noise, shots, trajectories, seed,
+                                           num_threads);
+            }, py::cast(&self));
+        }, "simulate_noisy in the background; returns a Future of counts",
+             py::arg("n_qubits"), py::arg("matches"), py::arg("iterations"), py::arg("noise"),
+             py::arg("shots") = 1000, py::arg("trajectories") = 100, py::arg("seed") = 42,
+             py::arg("num_threads") = 0)
+        .def("count_kmers", &GroverAccelerator::count_kmers,
+             "Count k-mers with partitioned per-thread hash tables",
+             py::arg("sequence"), py::arg("k"), py::arg("canonical") = true, py::arg("num_threads") = 4)
+        .def("count_pattern_matches", &GroverAccelerator::count_pattern_matches,
+             "Count pattern occurrences without materialising positions",
+             py::arg("sequence"), py::arg("pattern"), py::arg("mask") = nullptr)
         .def("find_pattern_matches_parallel", &GroverAccelerator::find_pattern_matches_parallel,
              "Parallel pattern matching for large sequences",
-             py::arg("sequence"), py::arg("pattern"), py::arg("num_threads") = 4)
-        .def("build_oracle_diagonal", &GroverAccelerator::build_oracle_diagonal,
-             "Fast diagonal matrix construction for oracle",
-             py::arg("matches"), py::arg("database_size"))
+             py::arg("sequence"), py::arg("pattern"), py::arg("num_threads") = 4,
+             py::arg("pin_threads") = false, py::arg("mask") = nullptr)
+        .def("find_pattern_matches_placed", &GroverAccelerator::find_pattern_matches_placed,
+             "Parallel pattern matching over a NUMA-placed sequence",
+             py::arg("sequence"), py::arg("pattern"), py::arg("mask") = nullptr)
+        .def("build_oracle_diagonal", [](GroverAccelerator& self, const std::vector<int>& matches, int database_size,
+                                         const SequenceMask* mask, int pattern_length) {
+            PageBuffer<std::complex<double>> diagonal;
+            {
+                py::gil_scoped_release release;
+                diagonal = self.build_oracle_diagonal(matches, database_size, mask, pattern_length);
+            }
+            return to_numpy(std::move(diagonal));
+        }, "Fast diagonal matrix construction for oracle; returns a complex128 array",
+             py::arg("matches"), py::arg("database_size"), py::arg("mask") = nullptr,
+             py::arg("pattern_length") = 1)
         .def("calculate_optimal_iterations", &GroverAccelerator::calculate_optimal_iterations,
              "Calculate optimal number of Grover iterations",
              py::arg("total_items"), py::arg("marked_items"))
+        .def("simulate_distributed", [](GroverAccelerator& self, int n_qubits, const std::vector<int>& matches,
+                                        int iterations, int num_ranks, int shots, uint64_t seed) {
+            // Each rank is a fresh interpreter that imports this module from the same directory
+            py::module_ os_path = py::module_::import("os.path");
+            const std::vector<std::string> rank_command = {
+                py::module_::import("sys").attr("executable").cast<std::string>(), "-c",
+                "import sys; sys.path.insert(0, sys.argv[1]); import grover_accelerator; "
+                "grover_accelerator._run_distributed_rank(sys.argv[2], int(sys.argv[3]))",
+                os_path.attr("dirname")(os_path.attr("abspath")(
+                    py::module_::import("grover_accelerator").attr("__file__"))).cast<std::string>()};
+            py::gil_scoped_release release;
+            return self.simulate_distributed(n_qubits, matches, iterations, num_ranks, shots, seed, rank_command);
+        }, "Grover simulation with the statevector split across local processes",
+             py::arg("n_qubits"), py::arg("matches"), py::arg("iterations"),
+             py::arg("num_ranks") = 2, py::arg("shots") = 1000, py::arg("seed") = 42)
+        .def("search_unknown_count", &GroverAccelerator::search_unknown_count,
+             "Grover search that does not need the match count ('bbht' schedule or quantum 'counting')",
+             py::arg("n_qubits"), py::arg("matches"), py::arg("seed") = 42,
+             py::arg("max_oracle_calls") = 0, py::arg("strategy") = "bbht",
+             py::arg("precision_qubits") = 0)
+        .def("quantum_count", &GroverAccelerator::quantum_count,
+             "Estimate the match count by simulated phase estimation of the Grover operator",
+             py::arg("n_qubits"), py::arg("matches"), py::arg("precision_qubits"), py::arg("seed") = 42)
+        .def("quantum_count_sweep", &GroverAccelerator::quantum_count_sweep,
+             "Exact quantum-counting accuracy for 1..max_precision_qubits counting qubits",
+             py::arg("n_qubits"), py::arg("matches"), py::arg("max_precision_qubits"))
+        .def("simulate_noisy", &GroverAccelerator::simulate_noisy,
+             "Noisy Grover simulation by parallel quantum trajectories",
+             py::arg("n_qubits"), py::arg("matches"), py::arg("iterations"), py::arg("noise"),
+             py::arg("shots") = 1000, py::arg("trajectories") = 100, py::arg("seed") = 42,
+             py::arg("num_threads") = 0)
         .def("analyze_measurement_statistics", &GroverAccelerator::analyze_measurement_statistics,
              "Statistical analysis of measurement results",
              py::arg("counts"), py::arg("expected_matches"), py::arg("total_shots"));
     
     // Utility functions
+    m.def("_run_distributed_rank", &GroverAccelerator::run_distributed_rank,
+          "Entry point of a simulate_distributed rank process", py::arg("name"), py::arg("rank"),
+          py::call_guard<py::gil_scoped_release>());
+    
     auto utils_module = m.def_submodule("utils", "Utility functions for DNA analysis");
     utils_module.def("generate_random_dna", &utils::generate_random_dna,
                      "Generate random DNA sequence for testing",
                      py::arg("length"), py::arg("seed") = 42);
     utils_module.def("is_valid_dna", &utils::is_valid_dna,
                      "Validate DNA sequence");
+    utils_module.def("reverse_complement", &utils::reverse_complement,
+                     "Reverse complement (IUPAC-aware, case-preserving)", py::arg("sequence"));
+    utils_module.def("reverse_complement_bytes",
+                     [](const std::string& sequence) {
+                         std::vector<uint8_t> rc(sequence.size());
+                         seqops::reverse_complement(sequence.data(), sequence.size(), reinterpret_cast<char*>(rc.data()));
+                         return to_numpy(std::move(rc));
+                     },
+                     "Reverse complement as a uint8 array, without a copy into a Python string",
+                     py::arg("sequence"));
+    utils_module.def("translate_six_frames", &utils::translate_six_frames,
+                     "Protein translations of frames +1, +2, +3, -1, -2, -3 (standard code)",
+                     py::arg("sequence"));
+    utils_module.def("canonical_kmers",
+                     [](const std::string& sequence, int k) {
+                         return to_numpy(seqops::canonical_kmers(sequence.data(), sequence.size(), k));
+                     },
+                     "Canonical 2-bit k-mer at each window start (uint64; all ones where the window "
+                     "holds a non-ACGT symbol)",
+                     py::arg("sequence"), py::arg("k"));
     utils_module.def("calculate_gc_content", &utils::calculate_gc_content,
                      "Calculate GC content of DNA sequence");
+    utils_module.def("set_huge_pages", &memory::set_huge_pages,
+                     "Select huge-page backing for large buffers ('off', 'transparent', '2M', '1G')",
+                     py::arg("mode"), py::arg("threshold") = size_t(2) << 20);
+    utils_module.def("memory_stats", []() {
+                         py::dict info;
+                         {
+                             std::lock_guard<std::mutex> lock(memory::config_mutex);
+                             info["mode"] = memory::config().mode;
+                             info["threshold"] = memory::config().threshold;
+                         }
+                         info["base_page_size"] = memory::base_page_size();
+                         info["transparent_huge_page_size"] = memory::transparent_huge_page_size();
+                         info["large_allocations"] = memory::stats().large_allocations.load();
+                         info["huge_page_allocations"] = memory::stats().huge_page_allocations.load();
+                         info["transparent_huge_page_requests"] = memory::stats().transparent_requests.load();
+                         info["bytes_mapped"] = memory::stats().bytes_mapped.load();
+                         info["last_page_size"] = memory::stats().last_page_size.load();
+                         info["anon_huge_bytes"] = memory::anon_huge_bytes();
+                         return info;
+                     },
+                     "Large-buffer allocation statistics: guaranteed page sizes, THP requests and THP-backed bytes");
+    utils_module.def("tuning_profile", [](bool recalibrate) {
+                         tuning::Profile profile;
+                         {
+                             py::gil_scoped_release release;  // Calibration can take a second
+                             profile = GroverAccelerator::tuned(recalibrate);
+                         }
+                         py::dict info;
+                         info["path"] = tuning::profile_path();
+                         info["source"] = profile.source;
+                         info["cpus"] = profile.cpus;
+                         info["scan_threads"] = profile.scan_threads;
+                         info["scan_parallel_threshold"] = profile.scan_parallel_threshold;
+                         info["scan_min_chunk"] = profile.scan_min_chunk;
+                         info["corpus_task_windows"] = profile.corpus_task_windows;
+                         info["scan_serial_mbps"] = profile.scan_serial_mbps;
+                         return info;
+                     },
+                     "Tuned search parameters, calibrating (and saving the profile) on first use",
+                     py::arg("recalibrate") = false);
+    utils_module.def("numa_nodes", []() { return numa::topology().node_cpus; },
+                     "Usable CPUs of each NUMA node");
     
     // Constants
     m.attr("DNA_BASES") = py::make_tuple('A', 'T', 'G', 'C');
@@ -25,6 +25,8 @@ def get_compile_args():
 def get_link_args():
     if platform.system() == "Windows":
         return []
+    elif platform.system() == "Linux":
+        return ["-pthread", "-lrt"]
     else:
         return ["-pthread"]
 
@@ -64,6 +66,7 @@ setup(
     Features:
     - Fast pattern matching with parallel processing
     - Optimized oracle construction
+    - Native Grover statevector simulation, including multi-process runs
     - Statistical analysis of quantum measurements
     - DNA sequence utilities and validation
     """,
@@ -10,6 +10,10 @@ It provides easy access to all the main functionality.
 import sys
 import os
 import argparse
+import socket
+import struct
+import tempfile
+import time
 
 # Add src directory to path
 src_path = os.path.join(os.path.dirname(__file__), 'src')
@@ -19,7 +23,80 @@ sys.path.insert(0, src_path)
 cpp_path = os.path.join(os.path.dirname(__file__), 'cpp')
 sys.path.insert(0, cpp_path)
 
-from grover_accelerated import GroverDNASearchAccelerated
+# Search daemon wire format (see SearchServer in cpp/grover_accelerator.cpp)
+REQUEST_MAGIC = 0x51565247   # "GRVQ"
+RESPONSE_MAGIC = 0x52565247  # "GRVR"
+OP_SEARCH, OP_NAMES = 1, 3
+
+def default_socket_path():
+    """Per-user daemon socket, overridable with GROVER_SOCKET."""
+    uid = os.getuid() if hasattr(os, 'getuid') else 0
+    return os.environ.get('GROVER_SOCKET', os.path.join(tempfile.gettempdir(), f'grover-{uid}.sock'))
+
+def _recv_exact(sock, size):
+    data = bytearray()
+    while len(data) < size:
+        chunk = sock.recv(size - len(data))
+        if not chunk:
+            raise ConnectionError("search daemon closed the connection")
+        data += chunk
+    return bytes(data)
+
+def daemon_request(sock, op, payload=b''):
+    """Send one request and return its payload; raises on a non-ok status."""
+    sock.sendall(struct.pack('<IHHI', REQUEST_MAGIC, 1, op, len(payload)) + payload)
+    magic, status, _, length = struct.unpack('<IHHI', _recv_exact(sock, 12))
+    if magic != RESPONSE_MAGIC:
+        raise ConnectionError("unexpected reply from search daemon")
+    body = _recv_exact(sock, length)
+    if status != 0:
+        raise RuntimeError(body.decode(errors='replace'))
+    return body
+
+def query_daemon(socket_path, motif, max_hits=100):
+    """Ask a running daemon for a motif; returns (total, [(record_name, offset), ...])."""
+    with socket.socket(socket.AF_UNIX, socket.SOCK_STREAM) as sock:
+        sock.connect(socket_path)
+        body = daemon_request(sock, OP_SEARCH, struct.pack('<II', max_hits, 0) + motif.encode())
+        total, returned = struct.unpack_from('<QI', body)
+        record_ids = struct.unpack_from(f'<{returned}I', body, 12)
+        offsets = struct.unpack_from(f'<{returned}Q', body, 12 + 4 * returned)
+        # Only the names of records that were hit
+        wanted = sorted(set(record_ids))
+        names = {}
+        for start in range(0, len(wanted), 65536):  # Stay under the 1 MiB request limit
+            chunk = wanted[start:start + 65536]
+            reply = daemon_request(sock, OP_NAMES, struct.pack(f'<{len(chunk)}I', *chunk))
+            names.update(zip(chunk, reply.decode().split('\n')))
+    return total, [(names[r], o) for r, o in zip(record_ids, offsets)]
+
+def serve(path, socket_path, index_k, batch_wait_us=200, batch_max=64):
+    """Load a reference once and answer queries until interrupted."""
+    import grover_accelerator
+    
+    with open(path, 'r') as f:
+        is_fasta = f.read(1) == '>'
+    if is_fasta:
+        server = grover_accelerator.SearchServer.from_fasta(path, index_k)
+    else:
+        sequence = read_dna_sequence(path)
+        if sequence is None:
+            return 1
+        corpus = grover_accelerator.SequenceCorpus([sequence], [os.path.basename(path)])
+        server = grover_accelerator.SearchServer(corpus, index_k)
+    server.set_batching(batch_wait_us, batch_max)
+    server.start(socket_path)
+    print(f"Serving {server.num_records} record(s) from {path} on {socket_path} (Ctrl+C to stop)")
+    try:
+        while True:
+            time.sleep(1)
+    except KeyboardInterrupt:
+        pass
+    finally:
+        server.stop()
+    stats = server.stats()
+    print(f"\nAnswered {int(stats['queries'])} queries, mean search {stats['mean_search_us']:.1f} us")
+    return 0
 
 def read_dna_sequence(filepath):
     """Read DNA sequence from a text file."""
@@ -57,6 +134,10 @@ Examples:
   # File input
   python run_grover.py --file dna_sequence.txt AGCT
   
+  # Search daemon: load a reference once, then query it repeatedly
+  python run_grover.py --serve genome.fa &
+  python run_grover.py --query AGCTAGCTAGCT
+  
   # Other options
   python src/grover_accelerated.py          # Full demo
   python examples/basic_usage.py            # Basic example
@@ -70,9 +151,36 @@ Examples:
                        help='Motif pattern to search for')
     parser.add_argument('--file', '-f', 
                        help='Read DNA sequence from file')
+    parser.add_argument('--serve', metavar='FILE',
+                       help='Run the search daemon over a FASTA or plain sequence file')
+    parser.add_argument('--query', metavar='MOTIF',
+                       help='Look up a motif exactly through a running search daemon')
+    parser.add_argument('--socket', default=default_socket_path(),
+                       help='Search daemon socket path (default: %(default)s)')
+    parser.add_argument('--index-k', type=int, default=11,
+                       help='k-mer index size for --serve; 0 disables the index (default: 11)')
+    parser.add_argument('--batch-wait-us', type=int, default=200,
+                       help='For --serve: longest a scan query waits to share a batch (default: 200)')
+    parser.add_argument('--batch-max', type=int, default=64,
+                       help='For --serve: queries per batched scan; 0 disables batching (default: 64)')
+    parser.add_argument('--max-hits', type=int, default=100,
+                       help='Hits to print for --query (default: 100)')
     
     args = parser.parse_args()
     
+    if args.serve:
+        return serve(args.serve, args.socket, args.index_k, args.batch_wait_us, args.batch_max)
+    if args.query:
+        try:
+            total, hits = query_daemon(args.socket, args.query.upper(), args.max_hits)
+        except (OSError, RuntimeError) as e:
+            print(f"Error querying search daemon at {args.socket}: {e}")
+            return 1
+        for name, offset in hits:
+            print(f"{name}:{offset}")
+        print(f"{total} match(es)" + (f", first {len(hits)} shown" if len(hits) < total else ""))
+        return 0
+    
     print("Grover DNA Search Algorithm")
     print("=" * 40)
     print()
@@ -117,6 +225,9 @@ Examples:
     print()
     
     try:
+        # Imported here so daemon queries skip the Qiskit start-up
+        from grover_accelerated import GroverDNASearchAccelerated
+        
         # Run Grover search
         grover = GroverDNASearchAccelerated(sequence, motif)
         counts = grover.run()
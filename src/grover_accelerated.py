@@ -34,7 +34,8 @@ except ImportError:
 class GroverDNASearchAccelerated:
     """Enhanced Grover search with optional C++ acceleration for DNA motif finding."""
     
-    def __init__(self, sequence: str, motif: str, use_accelerator: bool = True):
+    def __init__(self, sequence: str, motif: str, use_accelerator: bool = True,
+                 mask: Optional[str] = None):
         self.data = sequence
         self.pattern = motif
         
@@ -71,6 +72,18 @@ class GroverDNASearchAccelerated:
         if self.use_accelerator:
             gc_content = grover_accelerator.utils.calculate_gc_content(sequence)
             print(f"  GC Content: {gc_content:.1%}")
+        
+        # Optional low-complexity mask ("dust" or "entropy"); masked spans never match
+        self.mask = None
+        if mask is not None:
+            if mask not in ("dust", "entropy"):
+                raise ValueError(f"Unknown mask '{mask}' (expected 'dust' or 'entropy')")
+            if not self.use_accelerator:
+                warnings.warn("Low-complexity masking needs the C++ accelerator; searching unmasked")
+            else:
+                builder = getattr(grover_accelerator.SequenceMask, mask)
+                self.mask = builder(sequence)
+                print(f"  Masked:    {self.mask.masked_bases:,} bases ({mask})")
     
     def _calculate_qubits_needed(self) -> int:
         if self.num_candidates <= 1:
@@ -97,14 +110,13 @@ class GroverDNASearchAccelerated:
         """Find all positions where the pattern matches using accelerated search if available."""
         if self.use_accelerator:
             # Use C++ accelerated pattern matching
+            # Serial/parallel crossover and thread count come from the tuning profile
+            threads = self.accelerator.tuned_threads(self.data_length)
             start_time = time.time()
-            if self.data_length > 100000:  # Use parallel for large sequences
-                matches = self.accelerator.find_pattern_matches_parallel(
-                    self.data, self.pattern, num_threads=4
-                )
-                search_method = "C++ (parallel)"
+            matches = self.accelerator.find_pattern_matches_auto(self.data, self.pattern, mask=self.mask)
+            if threads > 1:
+                search_method = f"C++ (parallel, {threads} threads)"
             else:
-                matches = self.accelerator.find_pattern_matches(self.data, self.pattern)
                 search_method = "C++ (single-threaded)"
             search_time = time.time() - start_time
             
@@ -148,7 +160,8 @@ class GroverDNASearchAccelerated:
             # Use C++ accelerated oracle construction
             start_time = time.time()
             size = 2 ** self.n_qubits
-            diag = self.accelerator.build_oracle_diagonal(matches, size)
+            diag = self.accelerator.build_oracle_diagonal(matches, size, mask=self.mask,
+                                                          pattern_length=self.pattern_length)
             construction_time = time.time() - start_time
             print(f"Oracle construction completed using C++ in {construction_time:.4f}s")
         else:
@@ -178,6 +191,36 @@ class GroverDNASearchAccelerated:
         diffusion.h(range(self.n_qubits))
         return diffusion
     
+    def export_qasm(self, path: Optional[str] = None, num_iterations: Optional[int] = None,
+                    oracle_method: str = "auto", unrolled: bool = False) -> str:
+        """Compile the search circuit natively and return it as OpenQASM 3.
+        
+        Oracle and diffusion come from the native template cache and are
+        repeated with a for loop unless unrolled. Writes the source to path
+        when given and prints gate counts and depth.
+        """
+        if not self.use_accelerator:
+            raise RuntimeError("Native circuit export requires the C++ accelerator")
+        
+        matches = self._find_matching_positions()
+        if num_iterations is None:
+            N = self.num_candidates if self.num_candidates > 0 else 1
+            num_iterations = self.accelerator.calculate_optimal_iterations(N, max(1, len(matches)))
+        
+        start_time = time.time()
+        circuit = grover_accelerator.GroverCircuit(self.n_qubits, matches, num_iterations, oracle_method)
+        qasm = circuit.to_qasm(unrolled=unrolled)
+        compile_time = time.time() - start_time
+        
+        counts = circuit.gate_counts()
+        print(f"Compiled Grover circuit ({circuit.oracle_method} oracle) in {compile_time:.4f}s")
+        print(f"  Qubits: {circuit.n_qubits} + {circuit.num_ancillas} ancillas, depth {circuit.depth()}")
+        print("  Gates: " + ", ".join(f"{name}={count}" for name, count in sorted(counts.items())))
+        if path:
+            with open(path, "w") as f:
+                f.write(qasm)
+        return qasm
+    
     def _trim_counts(self, counts: Dict[str, int]) -> Dict[str, int]:
         """Normalize and aggregate raw simulator counts."""
         aggregated: Dict[str, int] = {}
@@ -190,8 +233,28 @@ class GroverDNASearchAccelerated:
             aggregated[trimmed] = aggregated.get(trimmed, 0) + value
         return aggregated
     
-    def run(self, num_iterations: Optional[int] = None) -> Dict[str, int]:
-        """Run the enhanced Grover search algorithm."""
+    def run(self, num_iterations: Optional[int] = None, backend: str = "aer",
+            num_ranks: int = 1, schedule: str = "standard") -> Dict[str, int]:
+        """Run the enhanced Grover search algorithm.
+        
+        backend="native" simulates the statevector in the C++ accelerator
+        instead of building a Qiskit circuit; num_ranks > 1 splits it across
+        that many local worker processes. On the native single-rank backend,
+        schedule="exact" (phase-matched, success 1) or "fixed_point" (success
+        >= 99% for any match fraction down to the current one) replaces the
+        standard iteration count; asking for it on any other backend, or with
+        num_ranks > 1, raises ValueError.
+        """
+        if schedule not in ("standard", "exact", "fixed_point"):
+            raise ValueError(f"Unknown schedule '{schedule}' (expected 'standard', 'exact' or 'fixed_point')")
+        if schedule != "standard":
+            if backend != "native":
+                raise ValueError(f"schedule='{schedule}' needs backend='native'")
+            if num_ranks > 1:
+                raise ValueError(f"schedule='{schedule}' is not supported with num_ranks > 1")
+            if not self.use_accelerator:
+                warnings.warn(f"schedule='{schedule}' needs the C++ accelerator; using the standard schedule")
+        
         matches = self._find_matching_positions()
         M = max(1, len(matches))
         N = self.num_candidates if self.num_candidates > 0 else 1
@@ -210,6 +273,24 @@ class GroverDNASearchAccelerated:
         print(f"  Iterations:     {num_iterations}")
         print(f"  Expected success probability: ~{100 * M / N:.1f}%")
         
+        if backend == "native" and self.use_accelerator:
+            execution_start = time.time()
+            if num_ranks > 1:
+                raw_counts = self.accelerator.simulate_distributed(
+                    self.n_qubits, matches, num_iterations, num_ranks=num_ranks, shots=1000
+                )
+            else:
+                simulator = grover_accelerator.GroverSimulator(self.n_qubits, matches)
+                if schedule == "exact" and matches:
+                    raw_counts = simulator.run_exact(shots=1000)
+                elif schedule == "fixed_point" and matches:
+                    raw_counts = simulator.run_fixed_point(0.1, M / simulator.dimension, shots=1000)
+                else:
+                    raw_counts = simulator.run(num_iterations, shots=1000)
+            execution_time = time.time() - execution_start
+            print(f"  Native simulation ({num_ranks} rank(s)): {execution_time:.4f}s")
+            return self._trim_counts(raw_counts)
+        
         # Build and execute quantum circuit
         circuit_start = time.time()
         qc = QuantumCircuit(self.n_qubits, self.n_qubits)
@@ -237,6 +318,33 @@ class GroverDNASearchAccelerated:
         
         return self._trim_counts(raw_counts)
     
+    def run_adaptive(self, seed: int = 42, strategy: str = "bbht") -> Dict[str, float]:
+        """Search without knowing the match count (native simulator).
+        
+        strategy is "bbht" (randomized schedule) or "counting" (estimate M by
+        quantum counting first). Reports the oracle calls actually used
+        alongside the expected and known-M counts, for query-complexity
+        benchmarks.
+        """
+        if not self.use_accelerator:
+            raise RuntimeError("Adaptive search requires the C++ accelerator")
+        
+        matches = self._find_matching_positions()
+        report = self.accelerator.search_unknown_count(self.n_qubits, matches, seed=seed,
+                                                       strategy=strategy)
+        
+        print(f"\nAdaptive ({strategy.upper()}) Grover Search:")
+        if "estimated_marked" in report:
+            print(f"  Estimated matches:     {report['estimated_marked']:.1f} (true {len(matches)})")
+        if report["found"]:
+            print(f"  Found match at position {int(report['position']):,}")
+        else:
+            print("  No match found within the oracle-call budget")
+        print(f"  Oracle calls:          {int(report['oracle_calls'])} in {int(report['rounds'])} rounds")
+        print(f"  Expected oracle calls: {report['expected_oracle_calls']:.1f}")
+        print(f"  Known-M oracle calls:  {int(report['known_m_oracle_calls'])}")
+        return report
+    
     def analyze(self, counts: Dict[str, int]) -> None:
         """Enhanced analysis with C++ acceleration if available."""
         print("\n" + "=" * 70)
@@ -3,10 +3,17 @@
 Test suite for the grover_accelerator C++ module
 """
 
+import os
 import sys
 import time
 import random
+import math
 import traceback
+import tempfile
+
+# Calibration writes a tuning profile on the first accelerator call; keep it
+# out of the developer's ~/.cache for the whole run
+os.environ["GROVER_TUNING_PROFILE"] = os.path.join(tempfile.mkdtemp(prefix="grover_tuning_"), "tuning.txt")
 
 def test_basic_import():
     """Test basic module import"""
@@ -58,6 +65,14 @@ def test_pattern_matching(accelerator):
         empty_pattern_matches = accelerator.find_pattern_matches(sequence, "")
         assert len(empty_pattern_matches) == 0, "Empty pattern should return no matches"
         
+        # IUPAC ambiguity codes: R is A/G, sequence N matches only pattern N
+        assert accelerator.find_pattern_matches_iupac("ACGTNacgRA", "ACR") == [0, 5], \
+            "Ambiguity codes should match any base they stand for, in either case"
+        assert accelerator.find_pattern_matches_iupac("AANAA", "ANA") == [1], \
+            "Sequence N should only match pattern N"
+        assert accelerator.find_pattern_matches_iupac(sequence, pattern) == matches, \
+            "Unambiguous patterns should match exactly"
+        
         print("Pattern matching tests passed")
         return True
         
@@ -84,12 +99,13 @@ def test_parallel_matching(accelerator):
         matches_parallel = accelerator.find_pattern_matches_parallel(sequence, pattern, 4)
         parallel_time = time.time() - start_time
         
-        # Sort both results for comparison (parallel might be out of order)
-        matches_single.sort()
-        matches_parallel.sort()
-        
+        # Chunks are written at prefix-sum offsets, so results arrive in order
         assert matches_single == matches_parallel, "Single and parallel results should match"
         
+        frequent = accelerator.find_pattern_matches_parallel(sequence, "A", 7)
+        assert frequent == accelerator.find_pattern_matches(sequence, "A"), \
+            "High-frequency motif should come back sorted without a merge"
+        
         speedup = single_time / parallel_time if parallel_time > 0 else float('inf')
         print(f"Parallel matching successful")
         print(f"  Single-threaded: {single_time:.4f}s")
@@ -104,6 +120,45 @@ def test_parallel_matching(accelerator):
         traceback.print_exc()
         return False
 
+def test_placed_matching(accelerator):
+    """Test NUMA-placed sequence matching"""
+    print("\nTesting NUMA-placed pattern matching...")
+    try:
+        import grover_accelerator
+        
+        sequence = grover_accelerator.utils.generate_random_dna(200000, seed=7)
+        pattern = "AGCTA"
+        expected = accelerator.find_pattern_matches(sequence, pattern)
+        
+        for policy in ("partition", "interleave"):
+            placed = grover_accelerator.PlacedSequence(sequence, num_threads=4, policy=policy)
+            assert len(placed) == len(sequence), "Placed sequence should keep its length"
+            assert len(placed.worker_nodes()) == 4, "Each worker should have a node"
+            
+            matches = accelerator.find_pattern_matches_placed(placed, pattern)
+            assert matches == expected, f"Placed results ({policy}) should match single-threaded"
+        
+        pinned = accelerator.find_pattern_matches_parallel(sequence, pattern, 4, pin_threads=True)
+        assert pinned == expected, "Pinned parallel results should match single-threaded"
+        
+        try:
+            grover_accelerator.PlacedSequence(sequence, 4, "scatter")
+            print("✗ Unknown policy should be rejected")
+            return False
+        except ValueError:
+            pass
+        
+        print("NUMA-placed matching successful")
+        print(f"  NUMA nodes: {len(grover_accelerator.utils.numa_nodes())}")
+        print(f"  Found {len(expected)} matches")
+        
+        return True
+        
+    except Exception as e:
+        print(f"✗ NUMA-placed matching failed: {e}")
+        traceback.print_exc()
+        return False
+
 def test_oracle_construction(accelerator):
     """Test oracle diagonal construction"""
     print("\nTesting oracle construction...")
@@ -134,6 +189,841 @@ def test_oracle_construction(accelerator):
         traceback.print_exc()
         return False
 
+def test_native_simulation(accelerator):
+    """Test native and distributed Grover statevector simulation"""
+    print("\nTesting native Grover simulation...")
+    try:
+        import grover_accelerator
+        
+        n_qubits = 8
+        marked = [3, 77, 200]
+        iterations = accelerator.calculate_optimal_iterations(2 ** n_qubits, len(marked))
+        marked_states = {bin(pos)[2:].zfill(n_qubits) for pos in marked}
+        
+        simulator = grover_accelerator.GroverSimulator(n_qubits, marked)
+        counts = simulator.run(iterations, shots=1000, seed=5)
+        assert sum(counts.values()) == 1000, "All shots should be counted"
+        assert all(len(state) == n_qubits for state in counts), "States should be n-bit strings"
+        assert simulator.success_probability() > 0.9, "Optimal iterations should amplify matches"
+        
+        probs = simulator.probabilities()
+        assert abs(sum(probs) - 1.0) < 1e-9, "Probabilities should be normalized"
+        
+        import os
+        import tempfile
+        storage = tempfile.mkdtemp()
+        expanded = grover_accelerator.GroverSimulator(n_qubits, marked, compressed=False)
+        expanded_counts = expanded.run(iterations, shots=1000, seed=5)
+        out_of_core = grover_accelerator.GroverSimulator(n_qubits, marked, storage_path=storage,
+                                                         compressed=False)
+        assert out_of_core.out_of_core, "Storage path should enable out-of-core mode"
+        assert expanded.kernel == "specialized", "Small in-memory states should use a specialized kernel"
+        assert out_of_core.kernel == "generic", "Out-of-core states should stream through the generic path"
+        assert out_of_core.run(iterations, shots=1000, seed=5) == expanded_counts, \
+            "Out-of-core results should match in-memory results"
+        assert os.listdir(storage) == [], "Scratch file should be removed once mapped"
+        
+        # An existing file is never a valid storage path, and must survive the attempt
+        keep = os.path.join(storage, "keep.txt")
+        with open(keep, "w") as f:
+            f.write("precious")
+        try:
+            grover_accelerator.GroverSimulator(n_qubits, marked, storage_path=keep, compressed=False).probabilities()
+            assert False, "A file as storage path should be rejected"
+        except ValueError:
+            pass
+        with open(keep) as f:
+            assert f.read() == "precious", "Existing files must not be truncated"
+        os.unlink(keep)
+        os.rmdir(storage)
+        
+        # The compressed two-amplitude state must agree with the full statevector
+        assert simulator.is_compressed, "Standard oracle and diffusion should stay compressed"
+        assert simulator.kernel == "compressed", "Compressed states report the compressed kernel"
+        full_probs = expanded.probabilities()
+        assert max(abs(a - b) for a, b in zip(probs, full_probs)) < 1e-12, \
+            "Compressed and expanded probabilities should agree"
+        
+        diagonal = [1.0] * (2 ** n_qubits)
+        for pos in marked:
+            diagonal[pos] = -1.0
+        simulator.apply_phase_oracle(diagonal)
+        assert simulator.is_compressed, "A uniform phase oracle should keep the state compressed"
+        diagonal[10] = 1j
+        simulator.apply_phase_oracle(diagonal)
+        assert not simulator.is_compressed, "A non-uniform phase oracle should expand the state"
+        
+        for num_ranks in (1, 2, 4):
+            distributed = accelerator.simulate_distributed(
+                n_qubits, marked, iterations, num_ranks=num_ranks, shots=1000, seed=5
+            )
+            assert sum(distributed.values()) == 1000, f"{num_ranks} ranks should return every shot"
+            hits = sum(c for state, c in distributed.items() if state in marked_states)
+            assert hits > 900, f"{num_ranks} ranks should mostly measure marked states"
+        
+        print("Native simulation successful")
+        print(f"  Success probability: {simulator.success_probability():.4f}")
+        print(f"  Iterations: {iterations}")
+        
+        return True
+        
+    except Exception as e:
+        print(f"✗ Native simulation failed: {e}")
+        traceback.print_exc()
+        return False
+
+def test_noisy_simulation(accelerator):
+    """Test trajectory-based noisy simulation"""
+    print("\nTesting noisy Grover simulation...")
+    try:
+        import grover_accelerator
+        
+        n_qubits = 6
+        marked = [9, 33]
+        iterations = accelerator.calculate_optimal_iterations(2 ** n_qubits, len(marked))
+        marked_states = {bin(pos)[2:].zfill(n_qubits) for pos in marked}
+        
+        def success_rate(counts):
+            return sum(c for state, c in counts.items() if state in marked_states) / sum(counts.values())
+        
+        ideal = accelerator.simulate_noisy(n_qubits, marked, iterations, grover_accelerator.NoiseModel(),
+                                           shots=1000, trajectories=20)
+        noise = grover_accelerator.NoiseModel(depolarizing=0.02, amplitude_damping=0.01, readout_error=0.02)
+        noisy = accelerator.simulate_noisy(n_qubits, marked, iterations, noise,
+                                           shots=1000, trajectories=20, num_threads=1)
+        noisy_parallel = accelerator.simulate_noisy(n_qubits, marked, iterations, noise,
+                                                    shots=1000, trajectories=20, num_threads=4)
+        
+        assert sum(noisy.values()) == 1000, "Every shot should be counted"
+        assert all(len(state) == n_qubits for state in noisy), "States should be n-bit strings"
+        assert noisy == noisy_parallel, "Seeded trajectories should not depend on thread count"
+        assert success_rate(noisy) < success_rate(ideal), "Noise should degrade the success rate"
+        
+        print("Noisy simulation successful")
+        print(f"  Ideal success rate: {success_rate(ideal):.3f}")
+        print(f"  Noisy success rate: {success_rate(noisy):.3f}")
+        
+        return True
+        
+    except Exception as e:
+        print(f"✗ Noisy simulation failed: {e}")
+        traceback.print_exc()
+        return False
+
+def test_adaptive_search(accelerator):
+    """Test BBHT search with an unknown number of matches"""
+    print("\nTesting adaptive (BBHT) search...")
+    try:
+        n_qubits = 12
+        marked = [5, 700, 3001]
+        
+        total_calls = 0
+        runs = 50
+        for seed in range(runs):
+            report = accelerator.search_unknown_count(n_qubits, marked, seed=seed)
+            assert report["found"] == 1.0, "BBHT should find a match"
+            assert int(report["position"]) in marked, "Reported position should be marked"
+            assert report["oracle_calls"] >= report["rounds"], "Each round checks its result"
+            total_calls += report["oracle_calls"]
+        
+        mean_calls = total_calls / runs
+        assert mean_calls < 3 * report["expected_oracle_calls"], "Query count should track expectation"
+        
+        empty = accelerator.search_unknown_count(n_qubits, [], max_oracle_calls=200)
+        assert empty["found"] == 0.0, "Nothing should be found without matches"
+        assert empty["oracle_calls"] >= 200, "Search should stop at the oracle-call budget"
+        
+        print("Adaptive search successful")
+        print(f"  Mean oracle calls: {mean_calls:.1f}")
+        print(f"  Expected oracle calls: {report['expected_oracle_calls']:.1f}")
+        print(f"  Known-M oracle calls: {int(report['known_m_oracle_calls'])}")
+        
+        return True
+        
+    except Exception as e:
+        print(f"✗ Adaptive search failed: {e}")
+        traceback.print_exc()
+        return False
+
+def test_quantum_counting(accelerator):
+    """Test match-count estimation by quantum counting"""
+    print("\nTesting quantum counting...")
+    try:
+        sequence = "ACGTTACGAAACGTACGGGACGT" * 20
+        pattern = "ACG"
+        matches = accelerator.find_pattern_matches(sequence, pattern)
+        true_count = accelerator.count_pattern_matches(sequence, pattern)
+        assert true_count == len(matches), "Count should agree with the match list"
+        
+        n_qubits = 9
+        sweep = accelerator.quantum_count_sweep(n_qubits, matches, 10)
+        assert len(sweep) == 10, "One row per precision-qubit count"
+        assert sweep[-1]["median_abs_error"] < sweep[0]["median_abs_error"], \
+            "More precision qubits should tighten the estimate"
+        for row in sweep:
+            assert row["coverage"] >= 8 / math.pi ** 2 - 1e-9, "Interval should meet its confidence"
+        
+        report = accelerator.quantum_count(n_qubits, matches, 8, seed=3)
+        assert report["lower"] <= report["estimate"] <= report["upper"], "Estimate inside its interval"
+        assert report["oracle_calls"] == 2 ** 8 - 1, "Phase estimation uses 2^t - 1 Grover operators"
+        
+        search = accelerator.search_unknown_count(n_qubits, matches, seed=1, strategy="counting")
+        assert search["found"] == 1.0, "Counting strategy should find a match"
+        assert int(search["position"]) in matches, "Reported position should be marked"
+        
+        print("Quantum counting successful")
+        print(f"  True count: {true_count}, estimate: {report['estimate']:.1f} "
+              f"[{report['lower']:.1f}, {report['upper']:.1f}]")
+        for row in sweep[::3]:
+            print(f"  t={int(row['precision_qubits'])}: median error {row['median_abs_error']:.2f}, "
+                  f"coverage {row['coverage']:.3f}")
+        
+        return True
+        
+    except Exception as e:
+        print(f"✗ Quantum counting failed: {e}")
+        traceback.print_exc()
+        return False
+
+def test_guaranteed_success():
+    """Test exact and fixed-point Grover schedules"""
+    print("\nTesting exact and fixed-point Grover...")
+    try:
+        import grover_accelerator
+        
+        GroverSimulator = grover_accelerator.GroverSimulator
+        n_qubits = 10
+        for marked in ([17], [3, 99], [1, 2, 3, 500, 900]):
+            simulator = GroverSimulator(n_qubits, marked)
+            counts = simulator.run_exact(shots=500)
+            assert simulator.success_probability() > 1 - 1e-9, "Exact Grover should succeed with certainty"
+            assert sum(counts.values()) == 500, "All shots should be counted"
+        
+        delta, min_fraction = 0.2, 0.01
+        phases = GroverSimulator.fixed_point_schedule(delta, min_fraction)
+        for num_marked in (11, 50, 200, 600, 1024):
+            simulator = GroverSimulator(n_qubits, list(range(num_marked)))
+            for oracle_phase, diffusion_phase in phases:
+                simulator.apply_generalized_iteration(oracle_phase, diffusion_phase)
+            assert simulator.success_probability() >= 1 - delta ** 2 - 1e-9, \
+                f"Fixed point should reach 1 - delta^2 with {num_marked} marked"
+        
+        standard = GroverSimulator(n_qubits, [17])
+        standard.apply_generalized_iteration(math.pi, math.pi)
+        reference = GroverSimulator(n_qubits, [17])
+        reference.iterate(1)
+        assert abs(standard.success_probability() - reference.success_probability()) < 1e-12, \
+            "Phases (pi, pi) should match the standard iteration"
+        
+        iterations, phase = GroverSimulator.exact_schedule(1 << n_qubits, 1)
+        print("Guaranteed-success schedules successful")
+        print(f"  Exact: {iterations} iterations at phase {phase:.4f}")
+        print(f"  Fixed point: {len(phases)} iterations for delta={delta}, fraction >= {min_fraction}")
+        
+        return True
+        
+    except Exception as e:
+        print(f"✗ Guaranteed-success schedules failed: {e}")
+        traceback.print_exc()
+        return False
+
+def test_circuit_compiler():
+    """Test native Grover circuit compilation to OpenQASM 3"""
+    print("\nTesting circuit compiler...")
+    try:
+        import grover_accelerator
+        
+        n_qubits = 8
+        sparse = grover_accelerator.GroverCircuit(n_qubits, [5, 40], 2)
+        assert sparse.oracle_method == "mcz", "Few matches should use multi-controlled Z"
+        assert sparse.num_ancillas == n_qubits - 3, "V-chain needs n - 3 ancillas"
+        
+        dense = grover_accelerator.GroverCircuit(n_qubits, list(range(0, 256, 2)), 2)
+        assert dense.oracle_method == "gray", "Many matches should use the Gray-code network"
+        
+        for circuit in (sparse, dense):
+            qasm = circuit.to_qasm(unrolled=True)
+            assert qasm.startswith("OPENQASM 3.0;"), "Output should be OpenQASM 3"
+            assert "c = measure q;" in qasm, "Circuit should end with measurement"
+            counts = circuit.gate_counts()
+            assert counts["measure"] == n_qubits, "Every data qubit is measured"
+            body = [line for line in qasm.splitlines()
+                    if line and not line.startswith(("OPENQASM", "include", "//", "qubit", "bit", "c ="))]
+            assert len(body) == sum(counts.values()) - counts["measure"], "Counts should match emitted gates"
+            assert 0 < circuit.depth() <= len(body) + 1, "Depth should be bounded by gate count"
+        
+        GroverCircuit = grover_accelerator.GroverCircuit
+        GroverCircuit.clear_cache()
+        GroverCircuit(n_qubits, [5, 40], 2)
+        repeated = GroverCircuit(n_qubits, [40, 5], 50)
+        info = GroverCircuit.cache_info()
+        assert info["oracles"] == 1 and info["diffusions"] == 1, "Templates should be compiled once"
+        assert info["hits"] == 2, "Second circuit should reuse oracle and diffusion"
+        
+        referenced = repeated.to_qasm()
+        assert "gate grover_oracle" in referenced and "for uint i in [0:49]" in referenced, \
+            "Repeats should reference gate definitions"
+        assert len(referenced) < len(repeated.to_qasm(unrolled=True)) / 10, "Reference form should stay compact"
+        
+        # Statevector check: run the unrolled gates and compare with GroverSimulator
+        def run_unrolled(circuit):
+            width = circuit.n_qubits + circuit.num_ancillas
+            state = [0j] * (1 << width)
+            state[0] = 1 + 0j
+            def qubit(token):
+                register, index = token.strip().rstrip("]").split("[")
+                return int(index) + (circuit.n_qubits if register == "anc" else 0)
+            for line in circuit.to_qasm(unrolled=True).splitlines():
+                if not line or line.startswith(("OPENQASM", "include", "//", "qubit", "bit", "c =")):
+                    continue
+                head, _, operands = line.rstrip(";").partition(" ")
+                name, _, angle = head.partition("(")
+                angle = float(angle.rstrip(")")) if angle else 0.0
+                qubits = [qubit(token) for token in operands.split(",")] if operands else []
+                if name == "gphase":
+                    state = [a * complex(math.cos(angle), math.sin(angle)) for a in state]
+                    continue
+                *controls, target = qubits
+                bit = 1 << target
+                for i in range(len(state)):
+                    if i & bit or not all(i >> c & 1 for c in controls):
+                        continue
+                    a, b = state[i], state[i | bit]
+                    if name == "h":
+                        state[i], state[i | bit] = (a + b) / math.sqrt(2), (a - b) / math.sqrt(2)
+                    elif name in ("x", "cx", "ccx"):
+                        state[i], state[i | bit] = b, a
+                    elif name in ("z", "cz"):
+                        state[i | bit] = -b
+                    elif name == "rz":
+                        state[i] = a * complex(math.cos(angle / 2), -math.sin(angle / 2))
+                        state[i | bit] = b * complex(math.cos(angle / 2), math.sin(angle / 2))
+                    else:
+                        raise AssertionError(f"unexpected gate {name}")
+            return state
+
+        rng = random.Random(60)
+        for width in range(1, 6):
+            for num_marked in (1, 2, (1 << width) // 2):
+                marked = rng.sample(range(1 << width), num_marked)
+                for method in ("mcz", "gray"):
+                    for iterations in (1, 2):
+                        circuit = grover_accelerator.GroverCircuit(width, marked, iterations, method, False)
+                        state = run_unrolled(circuit)
+                        data_mask = (1 << width) - 1
+                        assert all(abs(a) < 1e-9 for i, a in enumerate(state) if i & ~data_mask), \
+                            f"Ancillas should return to |0> ({method}, n={width})"
+                        simulator = grover_accelerator.GroverSimulator(width, marked)
+                        simulator.iterate(iterations)
+                        expected = simulator.probabilities()
+                        for i in range(1 << width):
+                            assert abs(abs(state[i]) ** 2 - expected[i]) < 1e-9, \
+                                f"Outcome {i} should match GroverSimulator ({method}, n={width}, M={num_marked})"
+
+        try:
+            grover_accelerator.GroverCircuit(n_qubits, [1], 1, "qram")
+            print("✗ Unknown oracle method should be rejected")
+            return False
+        except ValueError:
+            pass
+        
+        print("Circuit compilation successful")
+        print(f"  Sparse oracle: {sparse.gate_counts()}, depth {sparse.depth()}")
+        print(f"  Dense oracle: {dense.gate_counts()}, depth {dense.depth()}")
+        
+        return True
+        
+    except Exception as e:
+        print(f"✗ Circuit compilation failed: {e}")
+        traceback.print_exc()
+        return False
+
+def test_kmer_counting(accelerator):
+    """Test the partitioned k-mer counter"""
+    print("\nTesting k-mer counting...")
+    try:
+        import grover_accelerator
+        from collections import Counter
+        
+        utils = grover_accelerator.utils
+        sequence = utils.generate_random_dna(50000, seed=9) + "N" + "A" * 200
+        
+        for k, canonical in ((5, True), (15, False), (21, True)):
+            expected = Counter()
+            for i in range(len(sequence) - k + 1):
+                window = sequence[i:i + k]
+                if "N" in window:
+                    continue
+                if canonical:
+                    window = min(window, utils.reverse_complement(window))
+                expected[window] += 1
+            
+            spectrum = accelerator.count_kmers(sequence, k, canonical=canonical, num_threads=4)
+            assert spectrum.distinct == len(expected), f"Distinct k-mers should match for k={k}"
+            assert spectrum.total == sum(expected.values()), f"Total occurrences should match for k={k}"
+            kmers = list(spectrum.kmers())
+            assert kmers == sorted(kmers), "k-mers should be sorted"
+            for window, count in list(expected.items())[:50]:
+                assert spectrum.count(window) == count, f"Count of {window} should match"
+        
+        small = accelerator.count_kmers(sequence, 4)
+        dense = small.dense()
+        assert len(dense) == 4 ** 4 and sum(dense) == small.total, "Dense output should cover 4^k codes"
+        assert small.count("AAAA") == small.count("TTTT"), "Canonical counts are strand-independent"
+        
+        single = accelerator.count_kmers(sequence, 21, num_threads=1)
+        assert list(single.counts()) == list(spectrum.counts()), "Thread count should not change results"
+        
+        print("k-mer counting successful")
+        print(f"  k=21: {spectrum.distinct} distinct of {spectrum.total}")
+        print(f"  Abundance histogram (k=4, first 5): {small.histogram(10)[:5]}")
+        
+        return True
+        
+    except Exception as e:
+        print(f"✗ k-mer counting failed: {e}")
+        traceback.print_exc()
+        return False
+
+def test_low_complexity_masking(accelerator):
+    """Test DUST/entropy masking and masked searches"""
+    print("\nTesting low-complexity masking...")
+    try:
+        import grover_accelerator
+        
+        utils = grover_accelerator.utils
+        flank = utils.generate_random_dna(2000, seed=5)
+        sequence = flank[:1000] + "A" * 100 + flank[1000:1500] + "CA" * 50 + flank[1500:]
+        
+        for method in ("dust", "entropy"):
+            mask = getattr(grover_accelerator.SequenceMask, method)(sequence)
+            assert len(mask) == len(sequence), "Mask should cover the sequence"
+            assert mask.masked(1050) and mask.masked(1650), f"{method} should mask the repeats"
+            assert not mask.masked(10), f"{method} should leave random flank unmasked"
+        
+        random_mask = grover_accelerator.SequenceMask.dust(utils.generate_random_dna(20000, seed=6))
+        assert random_mask.masked_bases == 0, "Random sequence should not be masked"
+        
+        mask = grover_accelerator.SequenceMask.dust(sequence)
+        plain = accelerator.find_pattern_matches(sequence, "AAAA")
+        masked = accelerator.find_pattern_matches(sequence, "AAAA", mask=mask)
+        expected = [p for p in plain if not any(mask.masked(p + j) for j in range(4))]
+        assert masked == expected, "Masked search should drop windows touching the mask"
+        assert len(masked) < len(plain), "Poly-A hits should be removed"
+        assert accelerator.count_pattern_matches(sequence, "AAAA", mask=mask) == len(masked)
+        assert accelerator.find_pattern_matches_parallel(sequence, "AAAA", num_threads=3, mask=mask) == masked
+        assert accelerator.find_pattern_matches_iupac(sequence, "AAAA", mask=mask) == masked
+        
+        spans = grover_accelerator.SequenceMask.from_intervals(8, [(2, 4)])
+        diag = accelerator.build_oracle_diagonal([0, 1, 5], 8, mask=spans, pattern_length=2)
+        assert [d.real for d in diag[:6]] == [-1, 1, 1, 1, 1, -1], "Masked positions should stay unmarked"
+        
+        print("Low-complexity masking successful")
+        print(f"  DUST intervals: {mask.intervals()}")
+        print(f"  AAAA hits: {len(plain)} unmasked -> {len(masked)} masked")
+        
+        return True
+        
+    except Exception as e:
+        print(f"✗ Low-complexity masking failed: {e}")
+        traceback.print_exc()
+        return False
+
+def test_sequence_corpus(accelerator):
+    """Test multi-record corpus search"""
+    print("\nTesting sequence corpus...")
+    try:
+        import grover_accelerator
+        import tempfile
+        
+        records = ["ACGTACGTAA", "TTAC", "", "GTA"]
+        corpus = grover_accelerator.SequenceCorpus(records, ["chr1", "chr2", "empty", "chr3"])
+        assert corpus.num_records == 4 and corpus.total_length == 17, "Corpus should hold every record"
+        assert list(corpus.starts()) == [0, 10, 14, 14, 17], "Offset table should give record starts"
+        assert corpus.locate(10) == (1, 0), "Global position should map to (record, offset)"
+        
+        record_ids, offsets = accelerator.find_pattern_matches_corpus(corpus, "GTA")
+        assert list(zip(record_ids, offsets)) == [(0, 2), (0, 6), (3, 0)], "Hits should be per record"
+        assert "AATT" in corpus.sequence(), "Concatenation should contain the junction"
+        record_ids, offsets = accelerator.find_pattern_matches_corpus(corpus, "AATT")
+        assert len(offsets) == 0, "Matches must not cross record junctions"
+        
+        utils = grover_accelerator.utils
+        skewed = grover_accelerator.SequenceCorpus(
+            [utils.generate_random_dna(300000, seed=1)] + [utils.generate_random_dna(50, seed=s) for s in range(500)])
+        serial = accelerator.find_pattern_matches_corpus(skewed, "ACGT", num_threads=1)
+        balanced = accelerator.find_pattern_matches_corpus(skewed, "ACGT", num_threads=4)
+        assert list(serial[0]) == list(balanced[0]) and list(serial[1]) == list(balanced[1]), \
+            "Work-stealing search should give the same ordered hits"
+        expected = [(r, p) for r in range(len(skewed))
+                    for p in accelerator.find_pattern_matches(skewed.record(r), "ACGT")]
+        assert list(zip(balanced[0], balanced[1])) == expected, "Hits should be in (record, offset) order"
+        
+        # Several threads share the accelerator's pool (the GIL is released);
+        # every caller must get its own complete result and none may hang
+        import concurrent.futures
+        with concurrent.futures.ThreadPoolExecutor(max_workers=4) as callers:
+            futures = [callers.submit(accelerator.find_pattern_matches_corpus, skewed, "ACGT", 4) for _ in range(32)]
+            for future in futures:
+                record_ids, offsets = future.result(timeout=120)
+                assert list(offsets) == list(balanced[1]), "Concurrent corpus searches should not interfere"
+        
+        with tempfile.NamedTemporaryFile("w", suffix=".fa", delete=False) as fasta:
+            fasta.write(">chr1 first contig\nACGTAC\nGTAA\n>chr2\nTTAC\n")
+        loaded = grover_accelerator.SequenceCorpus.from_fasta(fasta.name)
+        os.unlink(fasta.name)
+        assert [loaded.name(r) for r in range(len(loaded))] == ["chr1", "chr2"], "FASTA names should load"
+        assert loaded.record(0) == records[0], "FASTA lines should be joined"
+        
+        with tempfile.NamedTemporaryFile("w", suffix=".fa", delete=False) as fasta:
+            fasta.write(">soft\nACGTacgt\nACGT\n")
+        soft = grover_accelerator.SequenceCorpus.from_fasta(fasta.name)
+        kept = grover_accelerator.SequenceCorpus.from_fasta(fasta.name, uppercase=False)
+        os.unlink(fasta.name)
+        assert soft.record(0) == "ACGTACGTACGT" and kept.record(0) == "ACGTacgtACGT", "Soft masking should be optional"
+        assert len(accelerator.find_pattern_matches_corpus(soft, "ACGT")[1]) == 3, \
+            "Soft-masked bases should match uppercase motifs"
+        index = grover_accelerator.KmerIndex(soft, 4)
+        assert index.search(soft, "ACGT")[0] == 3, "The index should find soft-masked matches too"
+        
+        print("Sequence corpus successful")
+        print(f"  Records: {corpus.num_records}, total length {corpus.total_length}")
+        
+        return True
+        
+    except Exception as e:
+        print(f"✗ Sequence corpus failed: {e}")
+        traceback.print_exc()
+        return False
+
+def test_auto_tuning(accelerator):
+    """Test calibrated search parameters and the persisted profile"""
+    print("\nTesting auto-tuning...")
+    try:
+        import grover_accelerator
+        import tempfile
+        
+        utils = grover_accelerator.utils
+        with tempfile.TemporaryDirectory() as directory:
+            path = os.path.join(directory, "tuning.txt")
+            previous = os.environ.get("GROVER_TUNING_PROFILE")
+            os.environ["GROVER_TUNING_PROFILE"] = path
+            try:
+                profile = utils.tuning_profile(recalibrate=True)
+                assert profile["path"] == path and os.path.exists(path), "Profile should be saved"
+                assert profile["source"] == "calibrated"
+                assert 1 <= profile["scan_threads"] <= profile["cpus"], "Thread count should fit the machine"
+                assert profile["corpus_task_windows"] > 0 and profile["scan_serial_mbps"] > 0
+                with open(path) as saved:
+                    assert f"scan_threads={profile['scan_threads']}" in saved.read(), "Profile file should be readable"
+            finally:
+                if previous is None:
+                    del os.environ["GROVER_TUNING_PROFILE"]
+                else:
+                    os.environ["GROVER_TUNING_PROFILE"] = previous
+        
+        sequence = utils.generate_random_dna(200000, seed=8)
+        assert accelerator.find_pattern_matches_auto(sequence, "ACGTA") == \
+            accelerator.find_pattern_matches(sequence, "ACGTA"), "Auto-tuned search should match serial"
+        threads = accelerator.tuned_threads(len(sequence))
+        assert threads == 1 or len(sequence) >= profile["scan_parallel_threshold"]
+        
+        print("Auto-tuning successful")
+        print(f"  Threads: {profile['scan_threads']}, parallel from {profile['scan_parallel_threshold']} bases, "
+              f"corpus tasks of {profile['corpus_task_windows']} windows")
+        
+        return True
+        
+    except Exception as e:
+        print(f"✗ Auto-tuning failed: {e}")
+        traceback.print_exc()
+        return False
+
+def test_async_api(accelerator):
+    """Test Future-returning entry points"""
+    print("\nTesting async API...")
+    try:
+        import asyncio
+        import concurrent.futures
+        import grover_accelerator
+        
+        utils = grover_accelerator.utils
+        sequence = utils.generate_random_dna(100000, seed=12)
+        
+        future = accelerator.find_pattern_matches_async(sequence, "ACGTA")
+        assert isinstance(future, concurrent.futures.Future), "Should return a concurrent.futures.Future"
+        assert future.result(timeout=60) == accelerator.find_pattern_matches(sequence, "ACGTA")
+        
+        corpus = grover_accelerator.SequenceCorpus([sequence[:50000], sequence[50000:]])
+        record_ids, offsets = accelerator.find_pattern_matches_corpus_async(corpus, "ACGTA").result(timeout=60)
+        expected = accelerator.find_pattern_matches_corpus(corpus, "ACGTA")
+        assert list(record_ids) == list(expected[0]) and list(offsets) == list(expected[1])
+        
+        # Jobs in flight together run on different executor threads and share the accelerator's pool
+        in_flight = [accelerator.find_pattern_matches_corpus_async(corpus, "ACGTA", num_threads=3) for _ in range(12)]
+        done, not_done = concurrent.futures.wait(in_flight, timeout=120)
+        assert not not_done, "Overlapping corpus jobs should all finish"
+        for future in done:
+            record_ids, offsets = future.result()
+            assert list(record_ids) == list(expected[0]) and list(offsets) == list(expected[1])
+        
+        async def gather_corpus_jobs():
+            futures = [accelerator.find_pattern_matches_corpus_async(corpus, "ACGTA", num_threads=2) for _ in range(8)]
+            return await asyncio.wait_for(asyncio.gather(*map(asyncio.wrap_future, futures)), timeout=120)
+        assert all(list(offsets) == list(expected[1]) for _, offsets in asyncio.run(gather_corpus_jobs())), \
+            "Gathered corpus jobs should each hold the full result"
+        
+        spectrum = accelerator.count_kmers_async(sequence, 11).result(timeout=60)
+        assert spectrum.total == accelerator.count_kmers(sequence, 11).total, "k-mer Future should hold the spectrum"
+        
+        failed = accelerator.count_kmers_async(sequence, 40)
+        assert isinstance(failed.exception(timeout=60), ValueError), "Errors should surface on the Future"
+        
+        async def pipeline():
+            # search -> simulate, awaiting native work from the event loop
+            matches = await asyncio.wrap_future(accelerator.find_pattern_matches_async(sequence, "ACGTA"))
+            positions = [m for m in matches if m < 2 ** 10][:4] or [0]
+            counts = await asyncio.wrap_future(accelerator.simulate_async(10, positions, 12, shots=200))
+            return matches, counts
+        matches, counts = asyncio.run(pipeline())
+        assert sum(counts.values()) == 200, "Simulation Future should hold all shots"
+        
+        print("Async API successful")
+        print(f"  {len(matches)} matches, {len(counts)} distinct outcomes")
+        
+        return True
+        
+    except Exception as e:
+        print(f"✗ Async API failed: {e}")
+        traceback.print_exc()
+        return False
+
+def test_search_daemon(accelerator):
+    """Test the k-mer index and the Unix-socket search daemon"""
+    print("\nTesting search daemon...")
+    try:
+        import grover_accelerator
+        import tempfile
+        
+        if not hasattr(grover_accelerator, "SearchServer"):
+            print("Search daemon not available on this platform")
+            return True
+        sys.path.insert(0, os.path.join(os.path.dirname(__file__), '..'))
+        from run_grover import query_daemon
+        
+        utils = grover_accelerator.utils
+        records = [utils.generate_random_dna(20000, seed=s) for s in range(5)]
+        corpus = grover_accelerator.SequenceCorpus(records, [f"chr{r}" for r in range(5)])
+        motif = records[3][1000:1016]
+        expected = list(zip(*accelerator.find_pattern_matches_corpus(corpus, motif)))
+        
+        index = grover_accelerator.KmerIndex(corpus, 8)
+        total, (record_ids, offsets) = index.search(corpus, motif)
+        assert total == len(expected) and list(zip(record_ids, offsets)) == expected, "Index should match the scan"
+        
+        start = int(corpus.starts()[3]) + 1000
+        mask = grover_accelerator.SequenceMask.from_intervals(corpus.total_length, [(start + 5, start + 6)])
+        masked_expected = list(zip(*accelerator.find_pattern_matches_corpus(corpus, motif, mask=mask)))
+        total, (record_ids, offsets) = index.search(corpus, motif, mask=mask)
+        assert (3, 1000) not in masked_expected and total == len(masked_expected) and \
+            list(zip(record_ids, offsets)) == masked_expected, "Masked index lookups should match the masked scan"
+        
+        server = grover_accelerator.SearchServer(corpus, index_k=8)
+        with tempfile.TemporaryDirectory() as directory:
+            path = os.path.join(directory, "grover.sock")
+            server.start(path)
+            try:
+                total, hits = query_daemon(path, motif)
+                assert total == len(expected) and hits == [(f"chr{r}", o) for r, o in expected], \
+                    "Daemon hits should match the corpus search"
+                total, hits = query_daemon(path, "ACG", max_hits=5)
+                assert len(hits) == 5 and total == len(accelerator.find_pattern_matches_corpus(corpus, "ACG")[1]), \
+                    "Short motifs should fall back to a scan and honour max_hits"
+                start = time.time()
+                for _ in range(200):
+                    query_daemon(path, motif)
+                latency_ms = (time.time() - start) * 1000 / 200
+            finally:
+                server.stop()
+            assert not os.path.exists(path), "Stopping should remove the socket"
+        
+        stats = server.stats()
+        assert stats["queries"] == 202 and stats["indexed_queries"] == 201
+        
+        server.set_mask(mask)
+        total, (record_ids, offsets) = server.search(motif)
+        assert total == len(masked_expected) and list(zip(record_ids, offsets)) == masked_expected, \
+            "The server should apply its mask to indexed queries"
+        masked_scan = accelerator.find_pattern_matches_corpus(corpus, "ACG", mask=mask)
+        assert server.search("ACG")[0] == len(masked_scan[1]), "The server should apply its mask to scans"
+        server.set_mask(None)
+        
+        print("Search daemon successful")
+        print(f"  Query round trip: {latency_ms:.3f} ms, mean search {stats['mean_search_us']:.1f} us")
+        
+        return True
+        
+    except Exception as e:
+        print(f"✗ Search daemon failed: {e}")
+        traceback.print_exc()
+        return False
+
+def test_shared_reference(accelerator):
+    """Test publishing a reference to shared memory and attaching from another process"""
+    print("\nTesting shared reference...")
+    try:
+        import subprocess
+        import grover_accelerator
+        
+        if not hasattr(grover_accelerator, "SharedReference"):
+            print("Shared references not available on this platform")
+            return True
+        
+        utils = grover_accelerator.utils
+        records = [utils.generate_random_dna(30000, seed=s) for s in range(4)]
+        corpus = grover_accelerator.SequenceCorpus(records, ["chrA", "chrB", "chrC", "chrD"])
+        motif = records[2][500:514]
+        expected = accelerator.find_pattern_matches_corpus(corpus, motif)
+        
+        name = f"/grover-test-{os.getpid()}"
+        grover_accelerator.SharedReference.publish(name, corpus, index_k=8)
+        try:
+            shared = grover_accelerator.SharedReference.attach(name)
+            assert shared.corpus.num_records == 4 and shared.corpus.name(3) == "chrD", "Records should attach"
+            view = shared.sequence_view()
+            assert not view.flags.writeable and bytes(view[:100]).decode() == records[0][:100], \
+                "Sequence view should be read-only shared bytes"
+            hits = accelerator.find_pattern_matches_corpus(shared.corpus, motif)
+            assert list(hits[1]) == list(expected[1]), "Attached corpus should search like the original"
+            total, (record_ids, offsets) = shared.index.search(shared.corpus, motif)
+            assert list(zip(record_ids, offsets)) == list(zip(*expected)), "Shared index should match the scan"
+            
+            worker = (
+                "import sys, grover_accelerator\n"
+                f"shared = grover_accelerator.SharedReference.attach({name!r})\n"
+                f"total, (ids, offsets) = shared.index.search(shared.corpus, {motif!r})\n"
+                "print(shared.corpus.total_length, total, *offsets)\n")
+            cpp_path = os.path.join(os.path.dirname(os.path.abspath(__file__)), '..', 'cpp')
+            env = dict(os.environ, PYTHONPATH=os.pathsep.join([cpp_path] + sys.path))
+            output = subprocess.run([sys.executable, "-c", worker], env=env, capture_output=True,
+                                    text=True, timeout=120, check=True).stdout.split()
+            assert [int(x) for x in output] == [corpus.total_length, len(expected[1])] + list(expected[1]), \
+                "Another process should see the same reference"
+        finally:
+            grover_accelerator.SharedReference.unlink(name)
+        assert shared.corpus.record(1) == records[1], "Mappings should outlive unlink"
+        
+        print("Shared reference successful")
+        print(f"  Segment: {shared.size_bytes / 1e6:.1f} MB for {corpus.total_length:,} bases plus index")
+        
+        return True
+        
+    except Exception as e:
+        print(f"✗ Shared reference failed: {e}")
+        traceback.print_exc()
+        return False
+
+def test_batch_scheduler(accelerator):
+    """Test multi-pattern search and batched concurrent queries"""
+    print("\nTesting batch scheduler...")
+    try:
+        import concurrent.futures
+        import grover_accelerator
+        
+        utils = grover_accelerator.utils
+        records = [utils.generate_random_dna(40000, seed=s) for s in range(3)]
+        corpus = grover_accelerator.SequenceCorpus(records)
+        patterns = ["ACGT", "CGTA", "ACGTACG", "TTT", "ACGT", "GA"]
+        multi = accelerator.find_pattern_matches_multi(corpus, patterns)
+        for pattern, (record_ids, offsets) in zip(patterns, multi):
+            expected = accelerator.find_pattern_matches_corpus(corpus, pattern)
+            assert list(record_ids) == list(expected[0]) and list(offsets) == list(expected[1]), \
+                f"One Aho-Corasick pass should match the scan for {pattern}"
+        
+        scheduler = grover_accelerator.BatchScheduler(corpus, max_wait_us=20000, max_batch=16)
+        queries = [patterns[i % len(patterns)] for i in range(24)]
+        with concurrent.futures.ThreadPoolExecutor(max_workers=24) as pool:
+            results = list(pool.map(lambda q: scheduler.search(q, max_hits=10), queries))
+        for pattern, (total, (record_ids, offsets)) in zip(queries, results):
+            expected = accelerator.find_pattern_matches_corpus(corpus, pattern)
+            assert total == len(expected[1]) and list(offsets) == list(expected[1][:10]), \
+                "Each caller should get its own result"
+        stats = scheduler.stats()
+        assert stats["requests"] == 24 and stats["batches"] < 24, "Concurrent queries should share batches"
+        assert stats["coalesced"] > 0, "Identical queries should be served once per batch"
+        
+        scheduler.configure(max_wait_us=0, max_batch=1)
+        assert scheduler.search("GA")[0] == len(multi[5][1]), "Unbatched configuration should still answer"
+        
+        mask = grover_accelerator.SequenceMask.from_intervals(corpus.total_length, [(0, 20000), (45000, 52000)])
+        masked = accelerator.find_pattern_matches_multi(corpus, patterns, mask=mask)
+        masked_scheduler = grover_accelerator.BatchScheduler(corpus, max_wait_us=1000, mask=mask)
+        for pattern, (record_ids, offsets) in zip(patterns, masked):
+            expected = accelerator.find_pattern_matches_corpus(corpus, pattern, mask=mask)
+            assert list(record_ids) == list(expected[0]) and list(offsets) == list(expected[1]), \
+                f"A masked Aho-Corasick pass should match the masked scan for {pattern}"
+            assert masked_scheduler.search(pattern, max_hits=5)[0] == len(expected[1]), \
+                "The scheduler should apply its mask"
+        
+        print("Batch scheduler successful")
+        print(f"  {int(stats['requests'])} queries in {int(stats['batches'])} batches, "
+              f"mean batch {stats['mean_batch']:.1f}, mean latency {stats['mean_latency_us']:.0f} us")
+        
+        return True
+        
+    except Exception as e:
+        print(f"✗ Batch scheduler failed: {e}")
+        traceback.print_exc()
+        return False
+
+def test_match_table(accelerator):
+    """Test columnar match results and the Arrow export"""
+    print("\nTesting match table...")
+    try:
+        import tempfile
+        import grover_accelerator
+        
+        corpus = grover_accelerator.SequenceCorpus(["AACGTTGGACGTCC", "TTACGTAA"], ["a", "b"])
+        table = accelerator.find_matches_table(corpus, "ACG")
+        rows = list(zip(table.record_ids(), table.positions(), table.strands()))
+        assert rows == [(0, 1, 1), (0, 2, -1), (0, 8, 1), (0, 9, -1), (1, 2, 1), (1, 3, -1)], \
+            "Rows should hold both strands in (record, position, strand) order"
+        assert all(table.scores() == 1.0) and not any(table.mismatches()), "Exact hits should score 1"
+        assert not table.positions().flags.writeable, "Column views should be read-only"
+        assert len(accelerator.find_matches_table(corpus, "ACG", both_strands=False)) == 3
+        mask = grover_accelerator.SequenceMask.from_intervals(corpus.total_length, [(1, 2)])
+        masked = accelerator.find_matches_table(corpus, "ACG", mask=mask)
+        assert list(zip(masked.record_ids(), masked.positions(), masked.strands())) == rows[1:], \
+            "A mask should drop only the hits whose window touches it"
+        
+        schema, array = table.__arrow_c_array__()
+        assert type(schema).__name__ == "PyCapsule" and type(array).__name__ == "PyCapsule", \
+            "Arrow export should use the PyCapsule interface"
+        
+        try:
+            import pyarrow
+        except ImportError:
+            pyarrow = None
+        if pyarrow is not None:
+            arrow = pyarrow.table(table)
+            assert arrow.column_names == ["record_id", "position", "strand", "score", "mismatches"]
+            assert arrow.column("position").to_pylist() == [1, 2, 8, 9, 2, 3]
+            with tempfile.TemporaryDirectory() as directory:
+                path = os.path.join(directory, "matches.parquet")
+                table.to_parquet(path)
+                import pyarrow.parquet
+                assert pyarrow.parquet.read_table(path).equals(arrow), "Parquet should round-trip"
+        
+        print("Match table successful")
+        print(f"  {len(table)} rows{'' if pyarrow else ' (pyarrow not installed, import skipped)'}")
+        
+        return True
+        
+    except Exception as e:
+        print(f"✗ Match table failed: {e}")
+        traceback.print_exc()
+        return False
+
 def test_optimal_iterations(accelerator):
     """Test optimal iteration calculation"""
     print("\nTesting optimal iteration calculation...")
@@ -211,6 +1101,8 @@ def test_utils():
         invalid_dna = "ATCGXYZ"
         assert grover_accelerator.utils.is_valid_dna(valid_dna), "Valid DNA should pass validation"
         assert not grover_accelerator.utils.is_valid_dna(invalid_dna), "Invalid DNA should fail validation"
+        assert not grover_accelerator.utils.is_valid_dna("ATCGN"), "Ambiguity codes are not plain DNA"
+        assert not grover_accelerator.utils.is_valid_dna("atcg"), "Soft-masked bases are not plain DNA"
         
         # Test GC content
         gc_test = "GGCC"  # 100% GC
@@ -232,6 +1124,98 @@ def test_utils():
         traceback.print_exc()
         return False
 
+def test_sequence_kernels():
+    """Test reverse complement, six-frame translation and canonical k-mers"""
+    print("\nTesting sequence kernels...")
+    try:
+        import grover_accelerator
+        
+        utils = grover_accelerator.utils
+        complement = {"A": "T", "C": "G", "G": "C", "T": "A", "N": "N", "a": "t", "c": "g", "g": "c", "t": "a"}
+        sequence = utils.generate_random_dna(1000, seed=3) + "NNacgtRY"
+        expected = "".join(complement.get(base, base) for base in reversed(sequence[:-2]))
+        rc = utils.reverse_complement(sequence)
+        assert rc[2:] == expected and rc[:2] == "RY", "Reverse complement should be IUPAC-aware"
+        assert bytes(utils.reverse_complement_bytes(sequence)) == rc.encode(), "Buffer form should match"
+        
+        frames = utils.translate_six_frames("ATGGCCATTGTAATGGGCCGCTGAAAGGGTGCCCGATAG")
+        assert len(frames) == 6, "Six reading frames"
+        assert frames[0] == "MAIVMGR*KGAR*", "Frame +1 should use the standard genetic code"
+        
+        plain = sequence[:1000]
+        packed = grover_accelerator.PackedSequence(plain)
+        assert len(packed) == len(plain) and packed.to_string() == plain, "Packing should round-trip"
+        assert packed.reverse_complement().to_string() == utils.reverse_complement(plain), \
+            "Packed reverse complement should match ASCII"
+        
+        k = 21
+        kmers = list(utils.canonical_kmers(plain, k))
+        assert kmers == list(packed.canonical_kmers(k)), "ASCII and packed k-mers should agree"
+        code = {"A": 0, "C": 1, "G": 2, "T": 3}
+        encode = lambda s: sum(code[b] << (2 * (len(s) - 1 - i)) for i, b in enumerate(s))
+        window = plain[100:100 + k]
+        assert kmers[100] == min(encode(window), encode(utils.reverse_complement(window))), \
+            "Canonical k-mer should be the smaller strand encoding"
+        assert utils.canonical_kmers("ACGTNACGT", 3)[2] == 2 ** 64 - 1, "Windows with N are flagged"
+        
+        print("Sequence kernels successful")
+        print(f"  Frames: {frames[:3]}")
+        
+        return True
+        
+    except Exception as e:
+        print(f"✗ Sequence kernels failed: {e}")
+        traceback.print_exc()
+        return False
+
+def test_huge_pages():
+    """Test huge-page backed buffers and memory instrumentation"""
+    print("\nTesting huge-page buffers...")
+    try:
+        import grover_accelerator
+        
+        utils = grover_accelerator.utils
+        sequence = utils.generate_random_dna(4 * 1024 * 1024, seed=11)
+        
+        utils.set_huge_pages("off")
+        plain = grover_accelerator.PlacedSequence(sequence, num_threads=2)
+        base_page = utils.memory_stats()["base_page_size"]
+        assert plain.page_size == base_page, "Heap buffers should use base pages"
+        
+        utils.set_huge_pages("transparent", threshold=1 << 20)
+        placed = grover_accelerator.PlacedSequence(sequence, num_threads=2)
+        stats = utils.memory_stats()
+        assert placed.page_size == base_page, "THP is only requested, so base pages are guaranteed"
+        assert stats["large_allocations"] >= 1, "Large buffer should be counted"
+        assert stats["bytes_mapped"] >= len(sequence), "Mapped bytes should cover the buffer"
+        
+        diagonal = grover_accelerator.GroverAccelerator().build_oracle_diagonal([3], 1 << 17)
+        index = grover_accelerator.KmerIndex(grover_accelerator.SequenceCorpus([sequence]), 10)
+        assert utils.memory_stats()["large_allocations"] >= stats["large_allocations"] + 3, \
+            "Oracle diagonals and index tables should be page-backed"
+        assert diagonal[3] == -1 and len(diagonal) == 1 << 17 and index.size_bytes > 0
+        
+        try:
+            utils.set_huge_pages("4M")
+            print("✗ Unknown huge-page mode should be rejected")
+            return False
+        except ValueError:
+            pass
+        finally:
+            utils.set_huge_pages("transparent")
+        
+        print("Huge-page buffers successful")
+        print(f"  Page size guaranteed: {placed.page_size:,} bytes")
+        print(f"  THP requests: {stats['transparent_huge_page_requests']:,}")
+        print(f"  THP-backed bytes: {stats['anon_huge_bytes']:,}")
+        
+        return True
+        
+    except Exception as e:
+        print(f"✗ Huge-page buffers failed: {e}")
+        traceback.print_exc()
+        return False
+
 def test_performance_comparison():
     """Compare C++ vs Python performance"""
     print("\nTesting performance comparison...")
@@ -290,10 +1274,28 @@ def run_all_tests():
         test_accelerator_creation,
         test_pattern_matching,
         test_parallel_matching,
+        test_placed_matching,
         test_oracle_construction,
         test_optimal_iterations,
+        test_native_simulation,
+        test_noisy_simulation,
+        test_adaptive_search,
+        test_quantum_counting,
+        test_guaranteed_success,
+        test_circuit_compiler,
+        test_kmer_counting,
+        test_low_complexity_masking,
+        test_sequence_corpus,
+        test_auto_tuning,
+        test_async_api,
+        test_search_daemon,
+        test_shared_reference,
+        test_batch_scheduler,
+        test_match_table,
         test_position_encoding,
         test_utils,
+        test_sequence_kernels,
+        test_huge_pages,
         test_performance_comparison,
     ]
     
@@ -306,7 +1308,12 @@ def run_all_tests():
             if test_func.__name__ == 'test_accelerator_creation':
                 success, accelerator = test_func()
             elif test_func.__name__ in ['test_pattern_matching', 'test_parallel_matching', 
-                                       'test_oracle_construction', 'test_optimal_iterations',
+                                       'test_placed_matching', 'test_oracle_construction', 'test_optimal_iterations',
+                                       'test_native_simulation', 'test_noisy_simulation',
+                                       'test_adaptive_search', 'test_quantum_counting', 'test_kmer_counting',
+                                       'test_low_complexity_masking', 'test_sequence_corpus',
+                                       'test_auto_tuning', 'test_async_api', 'test_search_daemon',
+                                       'test_shared_reference', 'test_batch_scheduler', 'test_match_table',
                                        'test_position_encoding']:
                 if accelerator is None:
                     print(f"Skipping {test_func.__name__} - no accelerator available")